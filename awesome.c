@@ -51,6 +51,7 @@
 #include "luaa.h"
 #include "common/version.h"
 #include "common/atoms.h"
+#include "common/signals.h"
 #include "common/xcursor.h"
 #include "common/xutil.h"
 #include "common/backtrace.h"
@@ -66,12 +67,16 @@ void
 awesome_atexit(bool restart)
 {
     lua_pushboolean(globalconf.L, restart);
-    signal_object_emit(globalconf.L, &global_signals, "exit", 1);
+    signal_object_emit_id(globalconf.L, &global_signals, SIGNAL_exit, 1);
+
+    refresh_stats_print(stderr);
 
     a_dbus_cleanup();
 
     systray_cleanup();
 
+    property_cleanup();
+
     /* Close Lua */
     lua_close(globalconf.L);
 
@@ -150,17 +155,26 @@ scan(xcb_query_tree_cookie_t tree_c)
         *(geom_wins[i]) = xcb_get_geometry_unchecked(globalconf.connection, wins[i]);
     }
 
+    xcb_window_t manage_wins[tree_c_len];
+    xcb_get_geometry_reply_t *manage_geoms[tree_c_len];
+    int manage_len = 0;
+
     for(i = 0; i < tree_c_len; i++)
     {
         if(!geom_wins[i] || !(geom_r = xcb_get_geometry_reply(globalconf.connection,
                                                               *(geom_wins[i]), NULL)))
             continue;
 
-        client_manage(wins[i], geom_r, true);
-
-        p_delete(&geom_r);
+        manage_wins[manage_len] = wins[i];
+        manage_geoms[manage_len] = geom_r;
+        manage_len++;
     }
 
+    client_manage_bulk(manage_wins, manage_geoms, manage_len);
+
+    for(i = 0; i < manage_len; i++)
+        p_delete(&manage_geoms[i]);
+
     p_delete(&tree_r);
 }
 
@@ -168,34 +182,58 @@ static void
 a_xcb_check(void)
 {
     xcb_generic_event_t *mouse = NULL, *event;
+    event_array_t events;
+
+    event_array_init(&events);
 
     while((event = xcb_poll_for_event(globalconf.connection)))
     {
-        /* We will treat mouse events later.
-         * We cannot afford to treat all mouse motion events,
-         * because that would be too much CPU intensive, so we just
-         * take the last we get after a bunch of events. */
-        if(XCB_EVENT_RESPONSE_TYPE(event) == XCB_MOTION_NOTIFY)
-        {
-            p_delete(&mouse);
-            mouse = event;
-        }
-        else
+        /* Drain everything that is pending, so that events which are
+         * superseded by a later one can be dropped before handling them. */
+        do
+            event_array_append(&events, event);
+        while((event = xcb_poll_for_event(globalconf.connection)));
+
+        event_coalesce(&events);
+
+        foreach(_event, events)
         {
-            uint8_t type = XCB_EVENT_RESPONSE_TYPE(event);
-            if((type == XCB_ENTER_NOTIFY || type == XCB_LEAVE_NOTIFY) && mouse)
+            if(!(event = *_event))
+                continue;
+
+            /* We will treat mouse events later.
+             * We cannot afford to treat all mouse motion events,
+             * because that would be too much CPU intensive, so we just
+             * take the last we get after a bunch of events. */
+            if(XCB_EVENT_RESPONSE_TYPE(event) == XCB_MOTION_NOTIFY)
             {
-                /* Make sure enter/motion/leave events are handled in the
-                 * correct order */
-                event_handle(mouse);
+                if(mouse)
+                    globalconf.coalesced.motionnotify++;
                 p_delete(&mouse);
-                mouse = NULL;
+                mouse = event;
+                *_event = NULL;
+            }
+            else
+            {
+                uint8_t type = XCB_EVENT_RESPONSE_TYPE(event);
+                if((type == XCB_ENTER_NOTIFY || type == XCB_LEAVE_NOTIFY) && mouse)
+                {
+                    /* Make sure enter/motion/leave events are handled in the
+                     * correct order */
+                    event_handle(mouse);
+                    p_delete(&mouse);
+                    mouse = NULL;
+                }
+                event_handle(event);
+                p_delete(_event);
             }
-            event_handle(event);
-            p_delete(&event);
         }
+
+        events.len = 0;
     }
 
+    event_array_wipe(&events);
+
     if(mouse)
     {
         event_handle(mouse);
@@ -218,9 +256,17 @@ static gint
 a_glib_poll(GPollFD *ufds, guint nfsd, gint timeout)
 {
     guint res;
+    gint64 t;
     awesome_refresh();
+    /* Do not wait for events before emitting the signals left by the
+     * refresh */
+    if(signal_object_deferred_pending())
+        timeout = 0;
+    t = g_get_monotonic_time();
     res = g_poll(ufds, nfsd, timeout);
+    t = refresh_phase_end(refresh_stats_current(), REFRESH_PHASE_POLL, t);
     a_xcb_check();
+    refresh_phase_end(refresh_stats_current(), REFRESH_PHASE_EVENTS, t);
     return res;
 }
 
@@ -242,6 +288,26 @@ exit_on_signal(gpointer data)
     return TRUE;
 }
 
+/** Function to print statistics on some signals.
+ * \param data currently unused
+ */
+static gboolean
+stats_on_signal(gpointer data)
+{
+    event_stats_print(stderr);
+    refresh_stats_print(stderr);
+    fprintf(stderr, "Signals: %lu emitted, %lu skipped, %lu deferred, %lu coalesced, %lu postponed\n",
+            signal_stats.emitted, signal_stats.skipped,
+            signal_stats.deferred, signal_stats.coalesced,
+            signal_stats.postponed);
+    fprintf(stderr, "Enter/leave: %lu scopes, %lu nested, %lu requests, %lu skipped\n",
+            enterleave_stats.scopes, enterleave_stats.nested,
+            enterleave_stats.requests, enterleave_stats.skipped);
+    fprintf(stderr, "Stacking: %lu refreshes, %lu windows, %lu requests\n",
+            stack_stats.refreshes, stack_stats.windows, stack_stats.requests);
+    return TRUE;
+}
+
 void
 awesome_restart(void)
 {
@@ -326,6 +392,9 @@ main(int argc, char **argv)
     /* Get XDG basedir data */
     xdgInitHandle(&xdg);
 
+    /* Compute the built-in signal identifiers */
+    signals_init();
+
     /* init lua */
     luaA_init(&xdg);
 
@@ -372,6 +441,7 @@ main(int argc, char **argv)
     g_unix_signal_add(SIGINT, exit_on_signal, NULL);
     g_unix_signal_add(SIGTERM, exit_on_signal, NULL);
     g_unix_signal_add(SIGHUP, restart_on_signal, NULL);
+    g_unix_signal_add(SIGUSR1, stats_on_signal, NULL);
 
     struct sigaction sa = { .sa_handler = signal_fatal, .sa_flags = 0 };
     sigemptyset(&sa.sa_mask);
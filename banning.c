@@ -21,51 +21,96 @@
 
 #include "banning.h"
 #include "objects/tag.h"
-#include "screen.h"
 
-/** Reban windows following current selected tags.
- * \param screen The screen to arrange.
+/** Recompute the visibility of a client like banning_client_update(), but
+ * without unfocusing it, which runs Lua code. This is for callers walking an
+ * array the Lua code could change, they have to call client_ban_unfocus()
+ * afterwards.
+ * \param c The client.
+ * \return True if the client was visible and is not anymore.
  */
-void
-banning_need_update(void)
+bool
+banning_client_check(client_t *c)
 {
-    /* We update the complete banning only once per main loop to avoid
-     * excessive updates...  */
-    globalconf.need_lazy_banning = true;
+    bool visible = !c->hidden && !c->minimized && client_maybevisible(c);
 
-    /* But if a client will be banned in our next update we unfocus it now. */
-    foreach(_c, globalconf.clients)
-    {
-        client_t *c = *_c;
+    if(c->visible == visible)
+        return false;
+
+    c->visible = visible;
 
-        if(!client_isvisible(c))
-            client_ban_unfocus(c);
+    if(!c->need_banning)
+    {
+        c->need_banning = true;
+        client_array_append(&globalconf.banning, c);
     }
+
+    return !visible;
+}
+
+/** Recompute the visibility of a client after something it depends on
+ * changed: its tags, the selection of one of them, or its sticky, hidden or
+ * minimized state.
+ * \param c The client.
+ */
+void
+banning_client_update(client_t *c)
+{
+    /* We update the banning only once per main loop to avoid
+     * excessive updates, but if the client will be banned we unfocus it now. */
+    if(banning_client_check(c))
+        client_ban_unfocus(c);
 }
 
-/** Check all clients if they need to rebanned
+/** Forget about a client which is being unmanaged.
+ * \param c The client.
+ */
+void
+banning_client_remove(client_t *c)
+{
+    if(!c->need_banning)
+        return;
+
+    c->need_banning = false;
+    foreach(elem, globalconf.banning)
+        if(*elem == c)
+        {
+            client_array_remove(&globalconf.banning, elem);
+            break;
+        }
+}
+
+/** Ban or unban the clients whose visibility changed.
  */
 void
 banning_refresh(void)
 {
-    if (!globalconf.need_lazy_banning)
+    client_array_t banning = globalconf.banning;
+
+    if (!banning.len)
         return;
 
-    globalconf.need_lazy_banning = false;
+    /* Unbanning may run Lua code which changes the visibility again, this
+     * is then handled at the next refresh. */
+    client_array_init(&globalconf.banning);
+    foreach(c, banning)
+        (*c)->need_banning = false;
 
     client_ignore_enterleave_events();
 
-    foreach(c, globalconf.clients)
-        if(client_isvisible(*c))
+    foreach(c, banning)
+        if((*c)->visible)
             client_unban(*c);
 
     /* Some people disliked the short flicker of background, so we first unban everything.
      * Afterwards we ban everything we don't want. This should avoid that. */
-    foreach(c, globalconf.clients)
-        if(!client_isvisible(*c))
+    foreach(c, banning)
+        if(!(*c)->visible)
             client_ban(*c);
 
     client_restore_enterleave_events();
+
+    client_array_wipe(&banning);
 }
 
 // vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -24,7 +24,9 @@
 
 #include "globalconf.h"
 
-void banning_need_update(void);
+bool banning_client_check(client_t *);
+void banning_client_update(client_t *);
+void banning_client_remove(client_t *);
 void banning_refresh(void);
 
 #endif
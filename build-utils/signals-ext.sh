@@ -0,0 +1,9 @@
+#!/bin/sh
+
+echo "/* This file is autogenerated by $0 - do not edit */"
+echo
+
+while read signal
+do
+    echo extern unsigned long SIGNAL_`echo $signal | sed 's/::/_/g'`\;
+done < $1
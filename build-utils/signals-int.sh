@@ -0,0 +1,20 @@
+#!/bin/sh
+
+echo "/* This file is autogenerated by $0 - do not edit */"
+echo
+
+while read signal
+do
+    echo unsigned long SIGNAL_`echo $signal | sed 's/::/_/g'`\;
+done < $1
+
+echo
+echo 'static signal_item_t SIGNAL_LIST[] ='
+echo '{'
+
+while read signal
+do
+    echo '    { "'$signal'", &SIGNAL_'`echo $signal | sed 's/::/_/g'`' },'
+done < $1
+
+echo '};'
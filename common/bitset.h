@@ -0,0 +1,107 @@
+/*
+ * common/bitset.h - growable bit sets header
+ *
+ * Copyright © 2014 awesome developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef AWESOME_COMMON_BITSET_H
+#define AWESOME_COMMON_BITSET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "common/util.h"
+
+#define BITSET_WORD_BITS 32
+
+/** A set of small integers, growing as needed. A zeroed bitset is empty. */
+typedef struct
+{
+    /** The bits, BITSET_WORD_BITS per word */
+    uint32_t *words;
+    /** Number of words */
+    int len;
+} bitset_t;
+
+static inline void
+bitset_wipe(bitset_t *set)
+{
+    p_delete(&set->words);
+    set->len = 0;
+}
+
+static inline bool
+bitset_test(const bitset_t *set, int bit)
+{
+    int word = bit / BITSET_WORD_BITS;
+    return word < set->len
+        && (set->words[word] & (UINT32_C(1) << (bit % BITSET_WORD_BITS)));
+}
+
+static inline void
+bitset_set(bitset_t *set, int bit)
+{
+    int word = bit / BITSET_WORD_BITS;
+    if(word >= set->len)
+    {
+        p_realloc(&set->words, word + 1);
+        p_clear(&set->words[set->len], word + 1 - set->len);
+        set->len = word + 1;
+    }
+    set->words[word] |= UINT32_C(1) << (bit % BITSET_WORD_BITS);
+}
+
+static inline void
+bitset_unset(bitset_t *set, int bit)
+{
+    int word = bit / BITSET_WORD_BITS;
+    if(word < set->len)
+        set->words[word] &= ~(UINT32_C(1) << (bit % BITSET_WORD_BITS));
+}
+
+/** Check if two bitsets have a bit in common.
+ * \param a A bitset.
+ * \param b Another bitset.
+ * \return True if a bit is set in both.
+ */
+static inline bool
+bitset_intersects(const bitset_t *a, const bitset_t *b)
+{
+    for(int i = 0; i < MIN(a->len, b->len); i++)
+        if(a->words[i] & b->words[i])
+            return true;
+    return false;
+}
+
+/** Find the first unset bit of a bitset.
+ * \param set The bitset.
+ * \return The index of the bit.
+ */
+static inline int
+bitset_first_unset(const bitset_t *set)
+{
+    for(int i = 0; i < set->len; i++)
+        if(set->words[i] != UINT32_MAX)
+            for(int bit = 0; bit < BITSET_WORD_BITS; bit++)
+                if(!(set->words[i] & (UINT32_C(1) << bit)))
+                    return i * BITSET_WORD_BITS + bit;
+    return set->len * BITSET_WORD_BITS;
+}
+
+#endif
+// vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -0,0 +1,73 @@
+/*
+ * common/histogram.c - latency histograms
+ *
+ * Copyright © 2014 awesome developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <inttypes.h>
+#include <lauxlib.h>
+
+#include "common/histogram.h"
+
+/** Push a histogram as a Lua table.
+ * The table has the fields count, total and max (times in seconds) and
+ * buckets, an array where buckets[1] counts samples below 1 microsecond and
+ * buckets[i] counts samples in [2^(i-2), 2^(i-1)) microseconds.
+ * \param L The Lua VM state.
+ * \param h The histogram.
+ */
+void
+luaA_histogram_push(lua_State *L, const histogram_t *h)
+{
+    lua_createtable(L, 0, 4);
+
+    lua_pushnumber(L, h->count);
+    lua_setfield(L, -2, "count");
+    lua_pushnumber(L, h->total / 1e6);
+    lua_setfield(L, -2, "total");
+    lua_pushnumber(L, h->max / 1e6);
+    lua_setfield(L, -2, "max");
+
+    lua_createtable(L, HISTOGRAM_BUCKETS, 0);
+    for(int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        lua_pushnumber(L, h->buckets[i]);
+        lua_rawseti(L, -2, i + 1);
+    }
+    lua_setfield(L, -2, "buckets");
+}
+
+/** Print a one line summary of a histogram.
+ * \param out The stream to print to.
+ * \param name The histogram name.
+ * \param h The histogram.
+ */
+void
+histogram_print(FILE *out, const char *name, const histogram_t *h)
+{
+    if(!h->count)
+        return;
+
+    fprintf(out, "%-32s %8" PRIu32 " calls, avg %8" PRIu64 "us, max %8" PRIu64 "us |",
+            name, h->count, h->total / h->count, h->max);
+    for(int i = 0; i < HISTOGRAM_BUCKETS; i++)
+        fprintf(out, " %" PRIu32, h->buckets[i]);
+    fputc('\n', out);
+}
+
+// vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
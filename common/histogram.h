@@ -0,0 +1,70 @@
+/*
+ * common/histogram.h - latency histograms header
+ *
+ * Copyright © 2014 awesome developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef AWESOME_COMMON_HISTOGRAM_H
+#define AWESOME_COMMON_HISTOGRAM_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <lua.h>
+
+/** Number of buckets of a histogram, the last one collects everything
+ * above 2^(HISTOGRAM_BUCKETS - 2) microseconds. */
+#define HISTOGRAM_BUCKETS 24
+
+/** A log-scale latency histogram. */
+typedef struct
+{
+    /** Number of samples */
+    uint32_t count;
+    /** Sum of all samples, in microseconds */
+    uint64_t total;
+    /** Largest sample, in microseconds */
+    uint64_t max;
+    /** Bucket 0 counts samples below 1 microsecond, bucket i > 0 counts
+     * samples in [2^(i-1), 2^i) microseconds */
+    uint32_t buckets[HISTOGRAM_BUCKETS];
+} histogram_t;
+
+/** Add a sample to a histogram.
+ * \param h The histogram.
+ * \param usec The sample, in microseconds.
+ */
+static inline void
+histogram_add(histogram_t *h, uint64_t usec)
+{
+    int bucket = 0;
+
+    for(uint64_t v = usec; v && bucket < HISTOGRAM_BUCKETS - 1; v >>= 1)
+        bucket++;
+
+    h->count++;
+    h->total += usec;
+    if(usec > h->max)
+        h->max = usec;
+    h->buckets[bucket]++;
+}
+
+void luaA_histogram_push(lua_State *, const histogram_t *);
+void histogram_print(FILE *, const char *, const histogram_t *);
+
+#endif
+// vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
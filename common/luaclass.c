@@ -39,6 +39,9 @@ DO_ARRAY(lua_class_t *, lua_class, DO_NOTHING)
 
 static lua_class_array_t luaA_classes;
 
+/** Incremented each time a property is added, to rebuild the dispatch tables */
+static unsigned int lua_class_property_generation = 1;
+
 /** Convert a object to a udata if possible.
  * \param L The Lua VM state.
  * \param ud The index.
@@ -155,6 +158,8 @@ luaA_class_add_property(lua_class_t *lua_class,
                         lua_class_propfunc_t cb_index,
                         lua_class_propfunc_t cb_newindex)
 {
+    /* Properties are stored by value, invalidate the dispatch tables */
+    lua_class_property_generation++;
     lua_class_property_array_insert(&lua_class->properties, (lua_class_property_t)
                                     {
                                         .name = name,
@@ -254,7 +259,7 @@ luaA_class_setup(lua_State *L, lua_class_t *class,
     if (parent)
         foreach(sig, parent->signals)
         {
-            signal_t s = { .id = sig->id };
+            signal_t s = { .id = sig->id, .property = sig->property };
             signal_array_insert(&class->signals, s);
         }
 
@@ -273,7 +278,8 @@ luaA_class_connect_signal_from_stack(lua_State *L, lua_class_t *lua_class,
                                      const char *name, int ud)
 {
     luaA_checkfunction(L, ud);
-    signal_connect(&lua_class->signals, name, luaA_object_ref(L, ud));
+    signal_connect(&lua_class->signals, name, luaA_function_ref(L, ud));
+    lua_class->listeners = signal_array_listeners(&lua_class->signals);
 }
 
 void
@@ -283,7 +289,8 @@ luaA_class_disconnect_signal_from_stack(lua_State *L, lua_class_t *lua_class,
     luaA_checkfunction(L, ud);
     void *ref = (void *) lua_topointer(L, ud);
     signal_disconnect(&lua_class->signals, name, ref);
-    luaA_object_unref(L, (void *) ref);
+    lua_class->listeners = signal_array_listeners(&lua_class->signals);
+    luaA_function_unref(L, (void *) ref);
     lua_remove(L, ud);
 }
 
@@ -294,6 +301,13 @@ luaA_class_emit_signal(lua_State *L, lua_class_t *lua_class,
     signal_object_emit(L, &lua_class->signals, name, nargs);
 }
 
+void
+luaA_class_emit_signal_id(lua_State *L, lua_class_t *lua_class,
+                          unsigned long id, int nargs)
+{
+    signal_object_emit_id(L, &lua_class->signals, id, nargs);
+}
+
 /** Try to use the metatable of an object.
  * \param L The Lua VM state.
  * \param idxobj The index of the object.
@@ -362,6 +376,72 @@ luaA_class_property_get(lua_State *L, lua_class_t *lua_class, int fieldidx)
     return NULL;
 }
 
+/** Fill a dispatch table with the properties and methods of a class.
+ * Parent classes are handled first so that the child class ones win.
+ * \param L The Lua VM state.
+ * \param lua_class The Lua class.
+ * \param tud The dispatch table index on the stack.
+ * \param methods Whether to fill the methods or the properties.
+ */
+static void
+luaA_class_dispatch_fill(lua_State *L, lua_class_t *lua_class, int tud, bool methods)
+{
+    if(lua_class->parent)
+        luaA_class_dispatch_fill(L, lua_class->parent, tud, methods);
+
+    if(methods)
+    {
+        /* Get the class metatable from registry */
+        lua_pushlightuserdata(L, lua_class);
+        lua_rawget(L, LUA_REGISTRYINDEX);
+        lua_pushnil(L);
+        while(lua_next(L, -2))
+        {
+            /* dispatch[key] = value */
+            lua_pushvalue(L, -2);
+            lua_insert(L, -2);
+            lua_rawset(L, tud);
+        }
+        lua_pop(L, 1);
+    }
+    else
+        foreach(prop, lua_class->properties)
+        {
+            lua_pushstring(L, prop->name);
+            lua_pushlightuserdata(L, prop);
+            lua_rawset(L, tud);
+        }
+}
+
+/** Look a field of an object up in the dispatch table of its class.
+ * The table maps each field name to the value found in the metatable of the
+ * class or of one of its parents, or to the lua_class_property_t as a light
+ * userdata. It is built on first use, and again after a property was added.
+ * \param L The Lua VM state.
+ * \param lua_class The Lua class.
+ * \param fieldidx The index of the field name.
+ * The value found, or nil if the field is unknown, is pushed on the stack.
+ */
+static void
+luaA_class_dispatch(lua_State *L, lua_class_t *lua_class, int fieldidx)
+{
+    if(lua_class->dispatch_generation != lua_class_property_generation)
+    {
+        if(lua_class->dispatch_generation)
+            luaL_unref(L, LUA_REGISTRYINDEX, lua_class->dispatch);
+        lua_newtable(L);
+        luaA_class_dispatch_fill(L, lua_class, lua_gettop(L), false);
+        luaA_class_dispatch_fill(L, lua_class, lua_gettop(L), true);
+        lua_class->dispatch = luaL_ref(L, LUA_REGISTRYINDEX);
+        lua_class->dispatch_generation = lua_class_property_generation;
+    }
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, lua_class->dispatch);
+    lua_pushvalue(L, fieldidx);
+    lua_rawget(L, -2);
+    lua_remove(L, -2);
+}
+
 /** Generic index meta function for objects.
  * \param L The Lua VM state.
  * \return The number of elements pushed on stack.
@@ -369,27 +449,32 @@ luaA_class_property_get(lua_State *L, lua_class_t *lua_class, int fieldidx)
 int
 luaA_class_index(lua_State *L)
 {
-    /* Try to use metatable first. */
-    if(luaA_usemetatable(L, 1, 2))
-        return 1;
-
     lua_class_t *class = luaA_class_get(L, 1);
 
-    lua_class_property_t *prop = luaA_class_property_get(L, class, 2);
+    /* Field names are looked up as strings, like the property names */
+    luaL_checkstring(L, 2);
+    luaA_class_dispatch(L, class, 2);
 
-    /* Property does exist and has an index callback */
-    if(prop)
-    {
-        if(prop->index)
-            return prop->index(L, luaA_checkudata(L, 1, class));
-    }
-    else
+    switch(lua_type(L, -1))
     {
+      case LUA_TNIL:
+        lua_pop(L, 1);
         if(class->index_miss_property)
             return class->index_miss_property(L, luaA_checkudata(L, 1, class));
+        return 0;
+      case LUA_TLIGHTUSERDATA:
+        {
+            lua_class_property_t *prop = lua_touserdata(L, -1);
+            lua_pop(L, 1);
+            /* Property does exist and has an index callback */
+            if(prop->index)
+                return prop->index(L, luaA_checkudata(L, 1, class));
+            return 0;
+        }
+      default:
+        /* A method */
+        return 1;
     }
-
-    return 0;
 }
 
 /** Generic newindex meta function for objects.
@@ -399,27 +484,115 @@ luaA_class_index(lua_State *L)
 int
 luaA_class_newindex(lua_State *L)
 {
-    /* Try to use metatable first. */
-    if(luaA_usemetatable(L, 1, 2))
+    lua_class_t *class = luaA_class_get(L, 1);
+
+    /* Field names are looked up as strings, like the property names */
+    luaL_checkstring(L, 2);
+    luaA_class_dispatch(L, class, 2);
+
+    switch(lua_type(L, -1))
+    {
+      case LUA_TNIL:
+        lua_pop(L, 1);
+        if(class->newindex_miss_property)
+            return class->newindex_miss_property(L, luaA_checkudata(L, 1, class));
+        return 0;
+      case LUA_TLIGHTUSERDATA:
+        {
+            lua_class_property_t *prop = lua_touserdata(L, -1);
+            lua_pop(L, 1);
+            /* Property does exist and has a newindex callback */
+            if(prop->newindex)
+                return prop->newindex(L, luaA_checkudata(L, 1, class));
+            return 0;
+        }
+      default:
+        /* Methods cannot be overwritten */
         return 1;
+    }
+}
 
-    lua_class_t *class = luaA_class_get(L, 1);
+/** Read some fields of an object into a table, as __index would.
+ * \param L The Lua VM state.
+ * \param oud The object index on the stack.
+ * \param namesidx The index of the array of field names.
+ * \param tud The index of the table to fill, keyed by field name.
+ */
+void
+luaA_class_get_props_fill(lua_State *L, int oud, int namesidx, int tud)
+{
+    oud = luaA_absindex(L, oud);
+    namesidx = luaA_absindex(L, namesidx);
+    tud = luaA_absindex(L, tud);
 
-    lua_class_property_t *prop = luaA_class_property_get(L, class, 2);
+    lua_class_t *class = luaA_class_get(L, oud);
+    void *object = luaA_checkudata(L, oud, class);
+    int len = luaA_rawlen(L, namesidx);
 
-    /* Property does exist and has a newindex callback */
-    if(prop)
+    for(int i = 1; i <= len; i++)
     {
-        if(prop->newindex)
-            return prop->newindex(L, luaA_checkudata(L, 1, class));
+        lua_rawgeti(L, namesidx, i);
+        luaL_checkstring(L, -1);
+        int top = lua_gettop(L);
+        luaA_class_dispatch(L, class, top);
+
+        if(lua_type(L, -1) == LUA_TLIGHTUSERDATA)
+        {
+            lua_class_property_t *prop = lua_touserdata(L, -1);
+            lua_pop(L, 1);
+            /* Call the property index callback directly, on the object and
+             * field name it would find on the stack from __index */
+            lua_pushvalue(L, oud);
+            lua_pushvalue(L, top);
+            int nret = prop->index ? prop->index(L, object) : 0;
+            /* Keep only the first value returned, if any */
+            if(nret > 0)
+                lua_pushvalue(L, lua_gettop(L) - nret + 1);
+            else
+                lua_pushnil(L);
+            lua_replace(L, top + 1);
+            lua_settop(L, top + 1);
+        }
+        else if(lua_isnil(L, -1))
+        {
+            /* Let the usual __index handle unknown fields */
+            lua_pop(L, 1);
+            lua_pushcfunction(L, luaA_class_index);
+            lua_pushvalue(L, oud);
+            lua_pushvalue(L, top);
+            lua_call(L, 2, 1);
+        }
+
+        /* table[name] = value */
+        lua_rawset(L, tud);
+    }
+}
+
+/** Read some fields of an object at once.
+ * \param L The Lua VM state.
+ * \return The number of elements pushed on stack.
+ * \luastack
+ * \lvalue An object.
+ * \lparam An array of field names.
+ * \lparam An optional table to fill, which is reused instead of creating one.
+ * \lreturn A table with the values of the fields, keyed by name.
+ */
+int
+luaA_class_get_props(lua_State *L)
+{
+    luaA_checktable(L, 2);
+    if(lua_isnoneornil(L, 3))
+    {
+        lua_settop(L, 2);
+        lua_newtable(L);
     }
     else
     {
-        if(class->newindex_miss_property)
-            return class->newindex_miss_property(L, luaA_checkudata(L, 1, class));
+        luaA_checktable(L, 3);
+        lua_settop(L, 3);
     }
-
-    return 0;
+    luaA_class_get_props_fill(L, 1, 2, 3);
+    return 1;
 }
 
 /** Generic constructor function for objects.
@@ -28,8 +28,13 @@ typedef struct lua_class_property lua_class_property_t;
 
 ARRAY_TYPE(lua_class_property_t, lua_class_property)
 
+/* The reference count only counts the references held by the C code, the
+ * registry slot keeps the object alive while there are some. */
 #define LUA_OBJECT_HEADER \
-        signal_array_t signals;
+        signal_array_t signals; \
+        uint64_t listeners; \
+        int refcount; \
+        int ref;
 
 /** Generic type for all objects.
  * All Lua objects can be casted to this type.
@@ -53,6 +58,8 @@ struct lua_class_t
     const char *name;
     /** Class signals */
     signal_array_t signals;
+    /** Listeners mask of the class signals, see signal_array_listeners() */
+    uint64_t listeners;
     /** Parent class */
     lua_class_t *parent;
     /** Allocator for creating new objects of that class */
@@ -69,6 +76,13 @@ struct lua_class_t
     lua_class_checker_t checker;
     /** Number of instances of this class in lua */
     unsigned int instances;
+    /** Emit the property::* signals of the instances at the next refresh */
+    bool defer_properties;
+    /** Registry reference of the table mapping field names to methods and
+     * properties, including the inherited ones */
+    int dispatch;
+    /** Properties generation the dispatch table was built for */
+    unsigned int dispatch_generation;
 };
 
 const char * luaA_typename(lua_State *, int);
@@ -78,6 +92,7 @@ void luaA_class_connect_signal(lua_State *, lua_class_t *, const char *, lua_CFu
 void luaA_class_connect_signal_from_stack(lua_State *, lua_class_t *, const char *, int);
 void luaA_class_disconnect_signal_from_stack(lua_State *, lua_class_t *, const char *, int);
 void luaA_class_emit_signal(lua_State *, lua_class_t *, const char *, int);
+void luaA_class_emit_signal_id(lua_State *, lua_class_t *, unsigned long, int);
 
 void luaA_openlib(lua_State *, const char *, const struct luaL_Reg[], const struct luaL_Reg[]);
 void luaA_class_setup(lua_State *, lua_class_t *, const char *, lua_class_t *,
@@ -93,6 +108,8 @@ int luaA_usemetatable(lua_State *, int, int);
 int luaA_class_index(lua_State *);
 int luaA_class_newindex(lua_State *);
 int luaA_class_new(lua_State *, lua_class_t *);
+void luaA_class_get_props_fill(lua_State *, int, int, int);
+int luaA_class_get_props(lua_State *);
 
 void * luaA_checkudata(lua_State *, int, lua_class_t *);
 void * luaA_toudata(lua_State *L, int ud, lua_class_t *);
@@ -142,6 +159,18 @@ luaA_checkudataornil(lua_State *L, int udx, lua_class_t *class)
     {                                                                          \
         lua_pushnumber(L, (lua_class).instances);                              \
         return 1;                                                              \
+    }                                                                          \
+                                                                               \
+    static inline int                                                          \
+    luaA_##prefix##_class_defer_property_signals(lua_State *L)                 \
+    {                                                                          \
+        if(lua_gettop(L) >= 1)                                                 \
+        {                                                                      \
+            luaL_checktype(L, 1, LUA_TBOOLEAN);                                \
+            (lua_class).defer_properties = lua_toboolean(L, 1);                \
+        }                                                                      \
+        lua_pushboolean(L, (lua_class).defer_properties);                      \
+        return 1;                                                              \
     }
 
 #define LUA_CLASS_METHODS(class) \
@@ -150,10 +179,12 @@ luaA_checkudataornil(lua_State *L, int udx, lua_class_t *class)
     { "disconnect_signal", luaA_##class##_class_disconnect_signal }, \
     { "emit_signal", luaA_##class##_class_emit_signal }, \
     { "instances", luaA_##class##_class_instances }, \
+    { "defer_property_signals", luaA_##class##_class_defer_property_signals }, \
 
 #define LUA_CLASS_META \
     { "__index", luaA_class_index }, \
-    { "__newindex", luaA_class_newindex },
+    { "__newindex", luaA_class_newindex }, \
+    { "get_props", luaA_class_get_props },
 
 #endif
 
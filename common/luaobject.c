@@ -151,6 +151,18 @@ luaA_object_decref(lua_State *L, int tud, const void *pointer)
     }
 }
 
+/** Report an object unreferenced more than it was referenced.
+ * \param pointer The object.
+ */
+void
+luaA_object_unref_bug(const void *pointer)
+{
+    buffer_t buf;
+    backtrace_get(&buf);
+    warn("BUG: Reference not found: %p\n%s", pointer, buf.s);
+    buffer_wipe(&buf);
+}
+
 int
 luaA_settype(lua_State *L, lua_class_t *lua_class)
 {
@@ -177,6 +189,8 @@ luaA_object_disconnect_signal(lua_State *L, int oud,
 }
 
 /** Add a signal to an object.
+ * Objects only store the signals something is connected to, the signal name
+ * is checked against the ones of the object class.
  * \param L The Lua VM state.
  * \param oud The object index on the stack.
  * \param name The name of the signal.
@@ -188,7 +202,19 @@ luaA_object_connect_signal_from_stack(lua_State *L, int oud,
 {
     luaA_checkfunction(L, ud);
     lua_object_t *obj = lua_touserdata(L, oud);
+    lua_class_t *lua_class = luaA_class_get(L, oud);
+
+    if(!signal_array_getbyid(&lua_class->signals,
+                             a_strhash((const unsigned char *) name)))
+    {
+        warn("Trying to connect to unknown signal '%s'", name);
+        lua_remove(L, ud);
+        return;
+    }
+
+    signal_add(&obj->signals, name);
     signal_connect(&obj->signals, name, luaA_object_ref_item(L, oud, ud));
+    obj->listeners |= SIGNAL_LISTENERS_BIT(a_strhash((const unsigned char *) name));
 }
 
 /** Remove a signal to an object.
@@ -204,17 +230,42 @@ luaA_object_disconnect_signal_from_stack(lua_State *L, int oud,
     luaA_checkfunction(L, ud);
     lua_object_t *obj = lua_touserdata(L, oud);
     void *ref = (void *) lua_topointer(L, ud);
-    signal_disconnect(&obj->signals, name, ref);
+    unsigned long id = a_strhash((const unsigned char *) name);
+    /* Objects only store the signals something was connected to, let
+     * signal_disconnect() warn about the ones unknown to the class */
+    if(signal_array_getbyid(&obj->signals, id)
+       || !signal_array_getbyid(&luaA_class_get(L, oud)->signals, id))
+        signal_disconnect(&obj->signals, name, ref);
+    obj->listeners = signal_array_listeners(&obj->signals);
     luaA_object_unref_item(L, oud, ref);
     lua_remove(L, ud);
 }
 
-void
-signal_object_emit(lua_State *L, signal_array_t *arr, const char *name, int nargs)
+/** Statistics about signal emission */
+signal_stats_t signal_stats;
+
+/** Get the name of a signal for error messages.
+ * \param id The signal identifier.
+ * \param name The signal name, or NULL for a built-in signal.
+ * \return The signal name.
+ */
+static const char *
+signal_object_name(unsigned long id, const char *name)
 {
-    signal_t *sigfound = signal_array_getbyid(arr,
-                                              a_strhash((const unsigned char *) name));
+    return name ? name : NONULL(signals_name(id));
+}
 
+/** Call the functions connected to a signal.
+ * \param L The Lua VM state.
+ * \param sigfound The signal, or NULL if it is unknown.
+ * \param id The signal identifier.
+ * \param name The signal name, for error messages, or NULL for a built-in signal.
+ * \param nargs The number of arguments to pass to the called functions.
+ */
+static void
+signal_object_call(lua_State *L, signal_t *sigfound,
+                   unsigned long id, const char *name, int nargs)
+{
     if(sigfound)
     {
         int nbfunc = sigfound->sigfuncs.len;
@@ -222,7 +273,7 @@ signal_object_emit(lua_State *L, signal_array_t *arr, const char *name, int narg
         /* Push all functions and then execute, because this list can change
          * while executing funcs. */
         foreach(func, sigfound->sigfuncs)
-            luaA_object_push(L, *func);
+            luaA_function_push(L, *func);
 
         for(int i = 0; i < nbfunc; i++)
         {
@@ -236,30 +287,70 @@ signal_object_emit(lua_State *L, signal_array_t *arr, const char *name, int narg
             luaA_dofunction(L, nargs, 0);
         }
     } else
-        warn("Trying to emit unknown signal '%s'", name);
+        warn("Trying to emit unknown signal '%s'", signal_object_name(id, name));
 
     /* remove args */
     lua_pop(L, nargs);
 }
 
-/** Emit a signal to an object.
+/** Emit a signal of a signal array.
  * \param L The Lua VM state.
- * \param oud The object index on the stack.
- * \param name The name of the signal.
+ * \param arr The signal array.
+ * \param id The signal identifier.
+ * \param name The signal name, for error messages, or NULL for a built-in signal.
  * \param nargs The number of arguments to pass to the called functions.
  */
-void
-luaA_object_emit_signal(lua_State *L, int oud,
-                        const char *name, int nargs)
+static void
+signal_object_emit_named(lua_State *L, signal_array_t *arr,
+                         unsigned long id, const char *name, int nargs)
 {
-    int oud_abs = luaA_absindex(L, oud);
-    lua_object_t *obj = lua_touserdata(L, oud);
-    if(!obj) {
-        warn("Trying to emit signal '%s' on non-object", name);
+    signal_t *sigfound = signal_array_getbyid(arr, id);
+
+    signal_stats.emitted++;
+
+    /* Nothing is connected, do not bother with the stack */
+    if(sigfound && !sigfound->sigfuncs.len)
+    {
+        signal_stats.skipped++;
+        lua_pop(L, nargs);
         return;
     }
-    signal_t *sigfound = signal_array_getbyid(&obj->signals,
-                                              a_strhash((const unsigned char *) name));
+
+    signal_object_call(L, sigfound, id, name, nargs);
+}
+
+void
+signal_object_emit(lua_State *L, signal_array_t *arr, const char *name, int nargs)
+{
+    signal_object_emit_named(L, arr, a_strhash((const unsigned char *) name), name, nargs);
+}
+
+/** Emit a built-in signal of a signal array.
+ * \param L The Lua VM state.
+ * \param arr The signal array.
+ * \param id The signal identifier, see common/signals.list.
+ * \param nargs The number of arguments to pass to the called functions.
+ */
+void
+signal_object_emit_id(lua_State *L, signal_array_t *arr, unsigned long id, int nargs)
+{
+    signal_object_emit_named(L, arr, id, NULL, nargs);
+}
+
+/** Call the functions connected to a signal of an object and of its class.
+ * \param L The Lua VM state.
+ * \param oud_abs The object absolute index on the stack.
+ * \param sigfound The object signal, or NULL if nothing connected to it.
+ * \param class_sigfound The class signal, or NULL if it is unknown.
+ * \param id The signal identifier.
+ * \param name The signal name, for error messages, or NULL for a built-in signal.
+ * \param nargs The number of arguments to pass to the called functions.
+ */
+static void
+signal_object_emit_now(lua_State *L, int oud_abs,
+                       signal_t *sigfound, signal_t *class_sigfound,
+                       unsigned long id, const char *name, int nargs)
+{
     if(sigfound)
     {
         int nbfunc = sigfound->sigfuncs.len;
@@ -282,13 +373,188 @@ luaA_object_emit_signal(lua_State *L, int oud,
             lua_remove(L, - nargs - nbfunc - 2 + i);
             luaA_dofunction(L, nargs + 1, 0);
         }
-    } else
-        warn("Trying to emit unknown signal '%s'", name);
+    }
 
-    /* Then emit signal on the class */
-    lua_pushvalue(L, oud);
+    /* Then emit signal on the class, which warns about unknown signals */
+    lua_pushvalue(L, oud_abs);
     lua_insert(L, - nargs - 1);
-    luaA_class_emit_signal(L, luaA_class_get(L, - nargs - 1), name, nargs + 1);
+    signal_object_call(L, class_sigfound, id, name, nargs + 1);
+}
+
+/** A property signal of an object waiting for the next refresh */
+typedef struct
+{
+    /** The object, referenced until the signal is emitted */
+    lua_object_t *object;
+    /** The signal identifier */
+    unsigned long id;
+} signal_deferred_t;
+
+DO_ARRAY(signal_deferred_t, signal_deferred, DO_NOTHING)
+
+/** Property signals waiting for the next refresh, in emission order */
+static signal_deferred_array_t signal_deferred;
+
+/** Record a property signal of an object to emit at the next refresh.
+ * A signal already waiting for that object is only emitted once.
+ * \param L The Lua VM state.
+ * \param oud_abs The object absolute index on the stack.
+ * \param obj The object.
+ * \param id The signal identifier.
+ */
+static void
+signal_object_defer(lua_State *L, int oud_abs, lua_object_t *obj, unsigned long id)
+{
+    signal_t *sigfound = signal_array_getbyid(&obj->signals, id);
+
+    signal_stats.deferred++;
+
+    if(!sigfound)
+    {
+        signal_t sig = { .id = id };
+        signal_array_insert(&obj->signals, sig);
+        sigfound = signal_array_getbyid(&obj->signals, id);
+    }
+
+    if(sigfound->deferred)
+    {
+        signal_stats.coalesced++;
+        return;
+    }
+
+    sigfound->deferred = true;
+    lua_pushvalue(L, oud_abs);
+    signal_deferred_t deferred = { .object = luaA_object_ref(L, -1), .id = id };
+    signal_deferred_array_append(&signal_deferred, deferred);
+}
+
+/** Check if some property signals are waiting for the next refresh.
+ * \return True if signal_object_emit_deferred() has something to emit.
+ */
+bool
+signal_object_deferred_pending(void)
+{
+    return signal_deferred.len > 0;
+}
+
+/** Emit the property signals deferred since the last call.
+ * Signals recorded by the called functions wait for the next call.
+ * \param L The Lua VM state.
+ */
+void
+signal_object_emit_deferred(lua_State *L)
+{
+    signal_deferred_array_t deferred = signal_deferred;
+    signal_deferred_array_init(&signal_deferred);
+
+    foreach(item, deferred)
+    {
+        signal_t *sigfound = signal_array_getbyid(&item->object->signals, item->id);
+        /* Clear it first, so that the called functions can record it again */
+        sigfound->deferred = false;
+        luaA_object_push(L, item->object);
+        int oud = lua_gettop(L);
+        signal_object_emit_now(L, oud,
+                               sigfound->sigfuncs.len ? sigfound : NULL,
+                               signal_array_getbyid(&luaA_class_get(L, oud)->signals,
+                                                    item->id),
+                               item->id, NULL, 0);
+        lua_pop(L, 1);
+        luaA_object_unref(L, item->object);
+    }
+
+    signal_deferred_array_wipe(&deferred);
+}
+
+/** Emit a signal to an object.
+ * \param L The Lua VM state.
+ * \param oud The object index on the stack.
+ * \param id The signal identifier.
+ * \param name The signal name, for error messages, or NULL for a built-in signal.
+ * \param nargs The number of arguments to pass to the called functions.
+ * \param defer Whether a property signal may wait for the next refresh. Only
+ * the emissions from the C code are deferred, Lua code emitting a property
+ * signal expects it to be emitted right away.
+ */
+static void
+luaA_object_emit_signal_named(lua_State *L, int oud,
+                              unsigned long id, const char *name, int nargs,
+                              bool defer)
+{
+    int oud_abs = luaA_absindex(L, oud);
+    lua_object_t *obj = lua_touserdata(L, oud);
+    if(!obj) {
+        warn("Trying to emit signal '%s' on non-object", signal_object_name(id, name));
+        return;
+    }
+    lua_class_t *lua_class = luaA_class_get(L, oud);
+
+    signal_stats.emitted++;
+
+    /* Nothing can be connected to the object nor to its class, do not look
+     * the signal up on the object. Signals emitted by name, as from Lua, are
+     * still checked against the class so that typos are warned about; the
+     * built-in identifiers come from common/signals.list. */
+    if(!((obj->listeners | lua_class->listeners) & SIGNAL_LISTENERS_BIT(id)))
+    {
+        if(name && !signal_array_getbyid(&lua_class->signals, id))
+            warn("Trying to emit unknown signal '%s'", name);
+        signal_stats.skipped++;
+        lua_pop(L, nargs);
+        return;
+    }
+
+    signal_t *sigfound = signal_array_getbyid(&obj->signals, id);
+    signal_t *class_sigfound = signal_array_getbyid(&lua_class->signals, id);
+
+    /* Only another signal sharing the listeners bit is connected. Objects
+     * only store the signals something was connected to, or which were
+     * deferred. */
+    if((!sigfound || !sigfound->sigfuncs.len)
+       && class_sigfound && !class_sigfound->sigfuncs.len)
+    {
+        signal_stats.skipped++;
+        lua_pop(L, nargs);
+        return;
+    }
+
+    /* Property changes of the classes asking for it are only recorded, and
+     * emitted once at the next refresh */
+    if(defer && class_sigfound && class_sigfound->property && !nargs
+       && lua_class->defer_properties)
+    {
+        signal_object_defer(L, oud_abs, obj, id);
+        return;
+    }
+
+    signal_object_emit_now(L, oud_abs, sigfound, class_sigfound, id, name, nargs);
+}
+
+/** Emit a signal to an object.
+ * \param L The Lua VM state.
+ * \param oud The object index on the stack.
+ * \param name The name of the signal.
+ * \param nargs The number of arguments to pass to the called functions.
+ */
+void
+luaA_object_emit_signal(lua_State *L, int oud,
+                        const char *name, int nargs)
+{
+    luaA_object_emit_signal_named(L, oud, a_strhash((const unsigned char *) name),
+                                  name, nargs, true);
+}
+
+/** Emit a built-in signal to an object.
+ * \param L The Lua VM state.
+ * \param oud The object index on the stack.
+ * \param id The signal identifier, see common/signals.list.
+ * \param nargs The number of arguments to pass to the called functions.
+ */
+void
+luaA_object_emit_signal_id(lua_State *L, int oud,
+                           unsigned long id, int nargs)
+{
+    luaA_object_emit_signal_named(L, oud, id, NULL, nargs, true);
 }
 
 int
@@ -308,10 +574,38 @@ luaA_object_disconnect_signal_simple(lua_State *L)
 int
 luaA_object_emit_signal_simple(lua_State *L)
 {
-    luaA_object_emit_signal(L, 1, luaL_checkstring(L, 2), lua_gettop(L) - 2);
+    const char *name = luaL_checkstring(L, 2);
+    luaA_object_emit_signal_named(L, 1, a_strhash((const unsigned char *) name),
+                                  name, lua_gettop(L) - 2, false);
     return 0;
 }
 
+/** Get statistics about signal emission.
+ * \param L The Lua VM state.
+ * \return The number of elements pushed on stack.
+ * \luastack
+ * \lreturn A table with the number of emitted signals, the number of them
+ * which were skipped because no function was connected, the number of deferred
+ * property signals, the number of them merged into a pending one and the
+ * number of refreshes which left some to the next one.
+ */
+int
+luaA_signal_stats(lua_State *L)
+{
+    lua_newtable(L);
+    lua_pushnumber(L, signal_stats.emitted);
+    lua_setfield(L, -2, "emitted");
+    lua_pushnumber(L, signal_stats.skipped);
+    lua_setfield(L, -2, "skipped");
+    lua_pushnumber(L, signal_stats.deferred);
+    lua_setfield(L, -2, "deferred");
+    lua_pushnumber(L, signal_stats.coalesced);
+    lua_setfield(L, -2, "coalesced");
+    lua_pushnumber(L, signal_stats.postponed);
+    lua_setfield(L, -2, "postponed");
+    return 1;
+}
+
 int
 luaA_object_tostring(lua_State *L)
 {
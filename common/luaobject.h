@@ -92,21 +92,70 @@ luaA_object_registry_push(lua_State *L)
     lua_rawget(L, LUA_REGISTRYINDEX);
 }
 
-/** Reference an object and return a pointer to it.
- * That only works with userdata, table, thread or function.
+/** Reference a function and return a pointer to it.
  * \param L The Lua VM state.
- * \param oud The object index on the stack.
- * \return The object reference, or NULL if not referenceable.
+ * \param fud The function index on the stack.
+ * \return The function reference.
  */
 static inline void *
-luaA_object_ref(lua_State *L, int oud)
+luaA_function_ref(lua_State *L, int fud)
 {
     luaA_object_registry_push(L);
-    void *p = luaA_object_incref(L, -1, oud < 0 ? oud - 1 : oud);
+    void *p = luaA_object_incref(L, -1, fud < 0 ? fud - 1 : fud);
     lua_pop(L, 1);
     return p;
 }
 
+/** Unreference a function.
+ * \param L The Lua VM state.
+ * \param pointer The function reference.
+ */
+static inline void
+luaA_function_unref(lua_State *L, const void *pointer)
+{
+    luaA_object_registry_push(L);
+    luaA_object_decref(L, -1, pointer);
+    lua_pop(L, 1);
+}
+
+/** Push a referenced function onto the stack.
+ * \param L The Lua VM state.
+ * \param pointer The function reference.
+ * \return The number of element pushed on stack.
+ */
+static inline int
+luaA_function_push(lua_State *L, const void *pointer)
+{
+    luaA_object_registry_push(L);
+    lua_pushlightuserdata(L, (void *) pointer);
+    lua_rawget(L, -2);
+    lua_remove(L, -2);
+    return 1;
+}
+
+void luaA_object_unref_bug(const void *);
+
+/** Reference an object and return a pointer to it.
+ * The object stays in a registry slot as long as it has references.
+ * \param L The Lua VM state.
+ * \param oud The object index on the stack, it is removed from the stack.
+ * \return The object reference, or NULL if not an object.
+ */
+static inline void *
+luaA_object_ref(lua_State *L, int oud)
+{
+    lua_object_t *obj = luaA_class_get(L, oud) ? lua_touserdata(L, oud) : NULL;
+
+    if(obj && !obj->refcount++)
+    {
+        lua_pushvalue(L, oud);
+        obj->ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    }
+
+    lua_remove(L, oud);
+    return obj;
+}
+
 /** Reference an object and return a pointer to it checking its type.
  * That only works with userdata.
  * \param L The Lua VM state.
@@ -121,17 +170,25 @@ luaA_object_ref_class(lua_State *L, int oud, lua_class_t *class)
     return luaA_object_ref(L, oud);
 }
 
-/** Unreference an object and return a pointer to it.
- * That only works with userdata, table, thread or function.
+/** Unreference an object.
  * \param L The Lua VM state.
- * \param oud The object index on the stack.
+ * \param pointer The object reference.
  */
 static inline void
 luaA_object_unref(lua_State *L, const void *pointer)
 {
-    luaA_object_registry_push(L);
-    luaA_object_decref(L, -1, pointer);
-    lua_pop(L, 1);
+    lua_object_t *obj = (lua_object_t *) pointer;
+
+    if(!obj)
+        return;
+
+    if(obj->refcount <= 0)
+        luaA_object_unref_bug(obj);
+    else if(!--obj->refcount)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, obj->ref);
+        obj->ref = LUA_NOREF;
+    }
 }
 
 /** Push a referenced object onto the stack.
@@ -142,24 +199,48 @@ luaA_object_unref(lua_State *L, const void *pointer)
 static inline int
 luaA_object_push(lua_State *L, const void *pointer)
 {
-    luaA_object_registry_push(L);
-    lua_pushlightuserdata(L, (void *) pointer);
-    lua_rawget(L, -2);
-    lua_remove(L, -2);
+    const lua_object_t *obj = pointer;
+
+    if(obj && obj->refcount)
+        lua_rawgeti(L, LUA_REGISTRYINDEX, obj->ref);
+    else
+        lua_pushnil(L);
     return 1;
 }
 
+/** Statistics about signal emission */
+typedef struct
+{
+    /** Number of emitted signals */
+    unsigned long emitted;
+    /** Number of emitted signals to which nothing was connected */
+    unsigned long skipped;
+    /** Number of property signals deferred until the next refresh */
+    unsigned long deferred;
+    /** Number of deferred property signals merged into a pending one */
+    unsigned long coalesced;
+    /** Number of refreshes which left deferred signals to the next one */
+    unsigned long postponed;
+} signal_stats_t;
+
+extern signal_stats_t signal_stats;
+
 void signal_object_emit(lua_State *, signal_array_t *, const char *, int);
+void signal_object_emit_id(lua_State *, signal_array_t *, unsigned long, int);
+void signal_object_emit_deferred(lua_State *);
+bool signal_object_deferred_pending(void);
 
 void luaA_object_connect_signal(lua_State *, int, const char *, lua_CFunction);
 void luaA_object_disconnect_signal(lua_State *, int, const char *, lua_CFunction);
 void luaA_object_connect_signal_from_stack(lua_State *, int, const char *, int);
 void luaA_object_disconnect_signal_from_stack(lua_State *, int, const char *, int);
 void luaA_object_emit_signal(lua_State *, int, const char *, int);
+void luaA_object_emit_signal_id(lua_State *, int, unsigned long, int);
 
 int luaA_object_connect_signal_simple(lua_State *);
 int luaA_object_disconnect_signal_simple(lua_State *);
 int luaA_object_emit_signal_simple(lua_State *);
+int luaA_signal_stats(lua_State *);
 
 #define LUA_OBJECT_FUNCS(lua_class, type, prefix)                              \
     LUA_CLASS_FUNCS(prefix, lua_class)                                         \
@@ -175,14 +256,7 @@ int luaA_object_emit_signal_simple(lua_State *);
         lua_setmetatable(L, -2);                                               \
         luaA_setuservalue(L, -2);                                              \
         lua_pushvalue(L, -1);                                                  \
-        /** @todo This is wrong we shouldn't copy the existing signals from */ \
-        /* the class, but I'm too lazy for doing this correctly right now. */  \
-        foreach(sig, (lua_class).signals)                                      \
-        {                                                                      \
-            signal_t s = { .id = sig->id };                                    \
-            signal_array_insert(&p->signals, s);                               \
-        }                                                                      \
-        luaA_class_emit_signal(L, &(lua_class), "new", 1);                     \
+        luaA_class_emit_signal_id(L, &(lua_class), SIGNAL_new, 1);             \
         return p;                                                              \
     }
 
@@ -22,8 +22,11 @@
 #ifndef AWESOME_COMMON_SIGNAL
 #define AWESOME_COMMON_SIGNAL
 
+#include <stdint.h>
+
 #include "common/lualib.h"
 #include "common/array.h"
+#include "common/signals.h"
 
 DO_ARRAY(const void *, cptr, DO_NOTHING)
 
@@ -31,6 +34,10 @@ typedef struct
 {
     unsigned long id;
     cptr_array_t sigfuncs;
+    /** Is it a property::* signal, which a class can defer? */
+    bool property;
+    /** Is an emission of this object signal deferred until the next refresh? */
+    bool deferred;
 } signal_t;
 
 static inline int
@@ -55,6 +62,25 @@ signal_array_getbyid(signal_array_t *arr, unsigned long id)
     return signal_array_lookup(arr, &sig);
 }
 
+/** Bit of a signal in a listeners mask. Signals share the bits, so a set bit
+ * only means something may be connected. */
+#define SIGNAL_LISTENERS_BIT(id) (UINT64_C(1) << ((id) % 64))
+
+/** Compute the listeners mask of a signal array: the bits of the signals
+ * which have functions connected.
+ * \param arr The signal array.
+ * \return The mask.
+ */
+static inline uint64_t
+signal_array_listeners(signal_array_t *arr)
+{
+    uint64_t listeners = 0;
+    foreach(sig, *arr)
+        if(sig->sigfuncs.len)
+            listeners |= SIGNAL_LISTENERS_BIT(sig->id);
+    return listeners;
+}
+
 /** Add a signal to a signal array.
  * Signals have to be added before they can be added or emitted.
  * \param arr The signal array.
@@ -67,7 +93,9 @@ signal_add(signal_array_t *arr, const char *name)
     signal_t *sigfound = signal_array_getbyid(arr, tok);
     if(!sigfound)
     {
-        signal_t sig = { .id = tok };
+        signal_t sig = { .id = tok,
+                         .property = !a_strncmp(name, "property::",
+                                                sizeof("property::") - 1) };
         signal_array_insert(arr, sig);
     }
 }
@@ -0,0 +1,56 @@
+/*
+ * signals.c - built-in signal identifiers
+ *
+ * Copyright © 2014 awesome developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "common/signals.h"
+#include "common/util.h"
+
+typedef struct
+{
+    const char *name;
+    unsigned long *id;
+} signal_item_t;
+
+#include "common/signals-intern.h"
+
+/** Compute the identifiers of the signals emitted by the C code, so that
+ * emitting them does not need to hash their name each time.
+ */
+void
+signals_init(void)
+{
+    for(unsigned int i = 0; i < countof(SIGNAL_LIST); i++)
+        *SIGNAL_LIST[i].id = a_strhash((const unsigned char *) SIGNAL_LIST[i].name);
+}
+
+/** Get the name of a built-in signal.
+ * \param id The signal identifier.
+ * \return The signal name, or NULL if this is not a built-in signal.
+ */
+const char *
+signals_name(unsigned long id)
+{
+    for(unsigned int i = 0; i < countof(SIGNAL_LIST); i++)
+        if(*SIGNAL_LIST[i].id == id)
+            return SIGNAL_LIST[i].name;
+    return NULL;
+}
+
+// vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
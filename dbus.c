@@ -413,7 +413,7 @@ a_dbus_process_request(DBusConnection *dbus_connection, DBusMessage *msg)
 
             int n = lua_gettop(globalconf.L) - nargs;
 
-            luaA_object_push(globalconf.L, (void *) func);
+            luaA_function_push(globalconf.L, (void *) func);
             luaA_dofunction(globalconf.L, nargs, LUA_MULTRET);
 
             n -= lua_gettop(globalconf.L);
@@ -766,7 +766,7 @@ luaA_dbus_connect_signal(lua_State *L)
     else
     {
         signal_add(&dbus_signals, name);
-        signal_connect(&dbus_signals, name, luaA_object_ref(L, 2));
+        signal_connect(&dbus_signals, name, luaA_function_ref(L, 2));
     }
     return 0;
 }
@@ -785,7 +785,7 @@ luaA_dbus_disconnect_signal(lua_State *L)
     luaA_checkfunction(L, 2);
     const void *func = lua_topointer(L, 2);
     signal_disconnect(&dbus_signals, name, func);
-    luaA_object_unref(L, func);
+    luaA_function_unref(L, func);
     return 0;
 }
 
@@ -39,8 +39,55 @@
 #include "luaa.h"
 #include "systray.h"
 #include "screen.h"
+#include "winindex.h"
 #include "common/atoms.h"
 #include "common/xutil.h"
+#include "common/histogram.h"
+
+/** Latencies of event handling */
+static struct
+{
+    /** Per event type */
+    histogram_t types[128];
+    /** Per atom, for PropertyNotify events */
+    GHashTable *properties;
+    /** Per atom, for the handling of property replies in property_refresh() */
+    GHashTable *property_updates;
+    /** Nesting depth of event_handle() */
+    int depth;
+    /** Time spent in the current event_handle() by nested event_handle()
+     * calls and property updates, accounted on their own */
+    gint64 nested;
+} event_stats;
+
+/** Number of main loop iterations kept by the refresh statistics */
+#define REFRESH_STATS_LEN 256
+
+/** Names of the main loop phases, by refresh_phase_t */
+static const char * const refresh_phase_names[REFRESH_PHASE_COUNT] =
+{
+    [REFRESH_PHASE_PROPERTY] = "property",
+    [REFRESH_PHASE_LUA] = "lua",
+    [REFRESH_PHASE_BANNING] = "banning",
+    [REFRESH_PHASE_STACK] = "stack",
+    [REFRESH_PHASE_FOCUS] = "focus",
+    [REFRESH_PHASE_FLUSH] = "flush",
+    [REFRESH_PHASE_POLL] = "poll",
+    [REFRESH_PHASE_EVENTS] = "events",
+};
+
+/** Timings of the main loop phases */
+static struct
+{
+    /** The last REFRESH_STATS_LEN iterations */
+    refresh_sample_t samples[REFRESH_STATS_LEN];
+    /** Number of iterations so far */
+    unsigned int iterations;
+    /** Number of refreshes done from within an iteration */
+    unsigned int nested;
+    /** Per phase, over all iterations */
+    histogram_t phases[REFRESH_PHASE_COUNT];
+} refresh_stats;
 
 #define DO_EVENT_HOOK_CALLBACK(type, xcbtype, xcbeventprefix, arraytype, match) \
     static void \
@@ -68,12 +115,12 @@
               case xcbeventprefix##_PRESS: \
                 for(int i = 0; i < nargs; i++) \
                     lua_pushvalue(globalconf.L, - nargs - item_matching); \
-                luaA_object_emit_signal(globalconf.L, - nargs - 1, "press", nargs); \
+                luaA_object_emit_signal_id(globalconf.L, - nargs - 1, SIGNAL_press, nargs); \
                 break; \
               case xcbeventprefix##_RELEASE: \
                 for(int i = 0; i < nargs; i++) \
                     lua_pushvalue(globalconf.L, - nargs - item_matching); \
-                luaA_object_emit_signal(globalconf.L, - nargs - 1, "release", nargs); \
+                luaA_object_emit_signal_id(globalconf.L, - nargs - 1, SIGNAL_release, nargs); \
                 break; \
             } \
             lua_pop(globalconf.L, 1); \
@@ -134,14 +181,14 @@ event_handle_mousegrabber(int x, int y, uint16_t mask)
 static void
 event_emit_button(xcb_button_press_event_t *ev)
 {
-    const char *name;
+    unsigned long signal;
     switch(XCB_EVENT_RESPONSE_TYPE(ev))
     {
     case XCB_BUTTON_PRESS:
-        name = "button::press";
+        signal = SIGNAL_button_press;
         break;
     case XCB_BUTTON_RELEASE:
-        name = "button::release";
+        signal = SIGNAL_button_release;
         break;
     default:
         fatal("Invalid event type");
@@ -153,7 +200,7 @@ event_emit_button(xcb_button_press_event_t *ev)
     lua_pushnumber(globalconf.L, ev->detail);
     luaA_pushmodifiers(globalconf.L, ev->state);
     /* And emit the signal */
-    luaA_object_emit_signal(globalconf.L, -5, name, 4);
+    luaA_object_emit_signal_id(globalconf.L, -5, signal, 4);
 }
 
 /** The button press event handler.
@@ -364,11 +411,12 @@ event_handle_destroynotify(xcb_destroy_notify_event_t *ev)
 
     if((c = client_getbywin(ev->window)))
         client_unmanage(c, false);
-    else
+    else if(winindex_has(WININDEX_XEMBED, ev->window))
         for(int i = 0; i < globalconf.embedded.len; i++)
             if(globalconf.embedded.tab[i].win == ev->window)
             {
                 xembed_window_array_take(&globalconf.embedded, i);
+                winindex_remove(WININDEX_XEMBED, ev->window);
                 luaA_systray_invalidate();
             }
 }
@@ -392,7 +440,7 @@ event_handle_motionnotify(xcb_motion_notify_event_t *ev)
         luaA_object_push(globalconf.L, c);
         lua_pushnumber(globalconf.L, ev->event_x);
         lua_pushnumber(globalconf.L, ev->event_y);
-        luaA_object_emit_signal(globalconf.L, -3, "mouse::move", 2);
+        luaA_object_emit_signal_id(globalconf.L, -3, SIGNAL_mouse_move, 2);
 
         /* now check if a titlebar was "hit" */
         int x = ev->event_x, y = ev->event_y;
@@ -402,7 +450,7 @@ event_handle_motionnotify(xcb_motion_notify_event_t *ev)
             luaA_object_push_item(globalconf.L, -1, d);
             lua_pushnumber(globalconf.L, x);
             lua_pushnumber(globalconf.L, y);
-            luaA_object_emit_signal(globalconf.L, -3, "mouse::move", 2);
+            luaA_object_emit_signal_id(globalconf.L, -3, SIGNAL_mouse_move, 2);
             lua_pop(globalconf.L, 1);
         }
         lua_pop(globalconf.L, 1);
@@ -414,7 +462,7 @@ event_handle_motionnotify(xcb_motion_notify_event_t *ev)
         luaA_object_push_item(globalconf.L, -1, w->drawable);
         lua_pushnumber(globalconf.L, ev->event_x);
         lua_pushnumber(globalconf.L, ev->event_y);
-        luaA_object_emit_signal(globalconf.L, -3, "mouse::move", 2);
+        luaA_object_emit_signal_id(globalconf.L, -3, SIGNAL_mouse_move, 2);
         lua_pop(globalconf.L, 2);
     }
 }
@@ -436,12 +484,12 @@ event_handle_leavenotify(xcb_leave_notify_event_t *ev)
     if((c = client_getbyframewin(ev->event)))
     {
         luaA_object_push(globalconf.L, c);
-        luaA_object_emit_signal(globalconf.L, -1, "mouse::leave", 0);
+        luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_mouse_leave, 0);
         drawable_t *d = client_get_drawable(c, ev->event_x, ev->event_y);
         if (d)
         {
             luaA_object_push_item(globalconf.L, -1, d);
-            luaA_object_emit_signal(globalconf.L, -1, "mouse::leave", 0);
+            luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_mouse_leave, 0);
             lua_pop(globalconf.L, 1);
         }
         lua_pop(globalconf.L, 1);
@@ -451,7 +499,7 @@ event_handle_leavenotify(xcb_leave_notify_event_t *ev)
     {
         luaA_object_push(globalconf.L, drawin);
         luaA_object_push_item(globalconf.L, -1, drawin->drawable);
-        luaA_object_emit_signal(globalconf.L, -1, "mouse::leave", 0);
+        luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_mouse_leave, 0);
         lua_pop(globalconf.L, 2);
     }
 }
@@ -474,19 +522,19 @@ event_handle_enternotify(xcb_enter_notify_event_t *ev)
     {
         luaA_object_push(globalconf.L, drawin);
         luaA_object_push_item(globalconf.L, -1, drawin->drawable);
-        luaA_object_emit_signal(globalconf.L, -1, "mouse::enter", 0);
+        luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_mouse_enter, 0);
         lua_pop(globalconf.L, 2);
     }
 
     if((c = client_getbyframewin(ev->event)))
     {
         luaA_object_push(globalconf.L, c);
-        luaA_object_emit_signal(globalconf.L, -1, "mouse::enter", 0);
+        luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_mouse_enter, 0);
         drawable_t *d = client_get_drawable(c, ev->event_x, ev->event_y);
         if (d)
         {
             luaA_object_push_item(globalconf.L, -1, d);
-            luaA_object_emit_signal(globalconf.L, -1, "mouse::enter", 0);
+            luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_mouse_enter, 0);
             lua_pop(globalconf.L, 1);
         }
         lua_pop(globalconf.L, 1);
@@ -605,7 +653,7 @@ event_handle_maprequest(xcb_map_request_event_t *ev)
     if(wa_r->override_redirect)
         goto bailout;
 
-    if(xembed_getbywin(&globalconf.embedded, ev->window))
+    if(winindex_has(WININDEX_XEMBED, ev->window))
     {
         xcb_map_window(globalconf.connection, ev->window);
         xembed_window_activate(globalconf.connection, ev->window);
@@ -650,11 +698,12 @@ event_handle_unmapnotify(xcb_unmap_notify_event_t *ev)
 
     if((c = client_getbywin(ev->window)))
         client_unmanage(c, true);
-    else
+    else if(winindex_has(WININDEX_XEMBED, ev->window))
         for(int i = 0; i < globalconf.embedded.len; i++)
             if(globalconf.embedded.tab[i].win == ev->window)
             {
                 xembed_window_array_take(&globalconf.embedded, i);
+                winindex_remove(WININDEX_XEMBED, ev->window);
                 xcb_change_save_set(globalconf.connection, XCB_SET_MODE_DELETE, ev->window);
                 luaA_systray_invalidate();
             }
@@ -793,7 +842,203 @@ xerror(xcb_generic_error_t *e)
     return;
 }
 
-void event_handle(xcb_generic_event_t *event)
+/** A PropertyNotify seen by the coalescing pass. */
+typedef struct
+{
+    xcb_atom_t atom;
+    /** Position of the event in the batch */
+    int idx;
+} event_coalesce_property_t;
+
+DO_ARRAY(event_coalesce_property_t, event_coalesce_property, DO_NOTHING)
+
+/** What the coalescing pass remembers about a window. */
+typedef struct
+{
+    /** Position of the last ConfigureRequest in the batch, or -1 */
+    int configurerequest;
+    /** Position of the last Expose in the batch, or -1 */
+    int expose;
+    /** The last PropertyNotify for each atom */
+    event_coalesce_property_array_t properties;
+} event_coalesce_t;
+
+static void
+event_coalesce_delete(gpointer data)
+{
+    event_coalesce_t *ec = data;
+    event_coalesce_property_array_wipe(&ec->properties);
+    p_delete(&ec);
+}
+
+/** Get the coalescing state of a window, creating it if needed.
+ * \param windows The table of windows seen so far.
+ * \param window The window.
+ * \return The coalescing state.
+ */
+static event_coalesce_t *
+event_coalesce_get(GHashTable *windows, xcb_window_t window)
+{
+    event_coalesce_t *ec = g_hash_table_lookup(windows, GUINT_TO_POINTER(window));
+
+    if(!ec)
+    {
+        ec = p_new(event_coalesce_t, 1);
+        ec->configurerequest = -1;
+        ec->expose = -1;
+        g_hash_table_insert(windows, GUINT_TO_POINTER(window), ec);
+    }
+
+    return ec;
+}
+
+/** Merge the values of an older ConfigureRequest into a newer one.
+ * Values set by the newer request win.
+ * \param ev The newer event.
+ * \param old The older event.
+ */
+static void
+event_coalesce_configurerequest(xcb_configure_request_event_t *ev,
+                                const xcb_configure_request_event_t *old)
+{
+    uint16_t missing = old->value_mask & ~ev->value_mask;
+
+    if(missing & XCB_CONFIG_WINDOW_X)
+        ev->x = old->x;
+    if(missing & XCB_CONFIG_WINDOW_Y)
+        ev->y = old->y;
+    if(missing & XCB_CONFIG_WINDOW_WIDTH)
+        ev->width = old->width;
+    if(missing & XCB_CONFIG_WINDOW_HEIGHT)
+        ev->height = old->height;
+    if(missing & XCB_CONFIG_WINDOW_BORDER_WIDTH)
+        ev->border_width = old->border_width;
+    if(missing & XCB_CONFIG_WINDOW_SIBLING)
+        ev->sibling = old->sibling;
+    if(missing & XCB_CONFIG_WINDOW_STACK_MODE)
+        ev->stack_mode = old->stack_mode;
+
+    ev->value_mask |= missing;
+}
+
+/** Grow a newer Expose event so that it also covers an older one.
+ * \param ev The newer event.
+ * \param old The older event.
+ */
+static void
+event_coalesce_expose(xcb_expose_event_t *ev, const xcb_expose_event_t *old)
+{
+    int x2 = MAX(ev->x + ev->width, old->x + old->width);
+    int y2 = MAX(ev->y + ev->height, old->y + old->height);
+
+    ev->x = MIN(ev->x, old->x);
+    ev->y = MIN(ev->y, old->y);
+    ev->width = x2 - ev->x;
+    ev->height = y2 - ev->y;
+}
+
+/** Drop the events of a batch which are superseded by a later event.
+ * Only the last PropertyNotify per window and atom is kept, ConfigureRequests
+ * for a window are merged into the last one and Expose rectangles for a
+ * window are unioned into the last one. Dropped events are freed and replaced
+ * by NULL, the order of the remaining events is untouched. Nothing is merged
+ * across a map, unmap, reparent or destroy of the window.
+ * \param events The batch of events.
+ */
+void
+event_coalesce(event_array_t *events)
+{
+    GHashTable *windows;
+
+    if(events->len < 2)
+        return;
+
+    windows = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                    NULL, event_coalesce_delete);
+
+    for(int i = 0; i < events->len; i++)
+    {
+        xcb_generic_event_t *event = events->tab[i];
+        xcb_window_t window = XCB_NONE;
+        event_coalesce_t *ec;
+
+        switch(XCB_EVENT_RESPONSE_TYPE(event))
+        {
+        case XCB_PROPERTY_NOTIFY:
+          {
+            xcb_property_notify_event_t *ev = (void *) event;
+            bool found = false;
+
+            ec = event_coalesce_get(windows, ev->window);
+            foreach(prop, ec->properties)
+                if(prop->atom == ev->atom)
+                {
+                    p_delete(&events->tab[prop->idx]);
+                    globalconf.coalesced.propertynotify++;
+                    prop->idx = i;
+                    found = true;
+                    break;
+                }
+            if(!found)
+                event_coalesce_property_array_append(&ec->properties,
+                        (event_coalesce_property_t) { .atom = ev->atom, .idx = i });
+            break;
+          }
+        case XCB_CONFIGURE_REQUEST:
+          {
+            xcb_configure_request_event_t *ev = (void *) event;
+
+            ec = event_coalesce_get(windows, ev->window);
+            if(ec->configurerequest >= 0)
+            {
+                event_coalesce_configurerequest(ev, (void *) events->tab[ec->configurerequest]);
+                p_delete(&events->tab[ec->configurerequest]);
+                globalconf.coalesced.configurerequest++;
+            }
+            ec->configurerequest = i;
+            break;
+          }
+        case XCB_EXPOSE:
+          {
+            xcb_expose_event_t *ev = (void *) event;
+
+            ec = event_coalesce_get(windows, ev->window);
+            if(ec->expose >= 0)
+            {
+                event_coalesce_expose(ev, (void *) events->tab[ec->expose]);
+                p_delete(&events->tab[ec->expose]);
+                globalconf.coalesced.expose++;
+            }
+            ec->expose = i;
+            break;
+          }
+        /* Never merge across a change of the window's state */
+        case XCB_MAP_REQUEST:
+            window = ((xcb_map_request_event_t *) event)->window;
+            break;
+        case XCB_MAP_NOTIFY:
+            window = ((xcb_map_notify_event_t *) event)->window;
+            break;
+        case XCB_UNMAP_NOTIFY:
+            window = ((xcb_unmap_notify_event_t *) event)->window;
+            break;
+        case XCB_REPARENT_NOTIFY:
+            window = ((xcb_reparent_notify_event_t *) event)->window;
+            break;
+        case XCB_DESTROY_NOTIFY:
+            window = ((xcb_destroy_notify_event_t *) event)->window;
+            break;
+        }
+
+        if(window != XCB_NONE)
+            g_hash_table_remove(windows, GUINT_TO_POINTER(window));
+    }
+
+    g_hash_table_destroy(windows);
+}
+
+static void
+event_dispatch(xcb_generic_event_t *event)
 {
     uint8_t response_type = XCB_EVENT_RESPONSE_TYPE(event);
 
@@ -843,4 +1088,321 @@ void event_handle(xcb_generic_event_t *event)
         event_handle_randr_screen_change_notify((void *) event);
 }
 
+/** Get the histogram of an atom, creating it if needed.
+ * \param table The per atom histograms.
+ * \param atom The atom.
+ * \return The histogram.
+ */
+static histogram_t *
+event_stats_atom_histogram(GHashTable **table, xcb_atom_t atom)
+{
+    histogram_t *h;
+
+    if(!*table)
+        *table = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, free);
+    if(!(h = g_hash_table_lookup(*table, GUINT_TO_POINTER(atom))))
+    {
+        h = p_new(histogram_t, 1);
+        g_hash_table_insert(*table, GUINT_TO_POINTER(atom), h);
+    }
+    return h;
+}
+
+/** Account the handling of a property reply.
+ * \param atom The property atom.
+ * \param elapsed The time it took, in microseconds.
+ */
+void
+event_stats_property_update(xcb_atom_t atom, gint64 elapsed)
+{
+    histogram_add(event_stats_atom_histogram(&event_stats.property_updates, atom), elapsed);
+    if(event_stats.depth)
+        event_stats.nested += elapsed;
+}
+
+/** Handle an event and account the time it took.
+ * \param event The event.
+ */
+void
+event_handle(xcb_generic_event_t *event)
+{
+    uint8_t response_type = XCB_EVENT_RESPONSE_TYPE(event);
+    gint64 outer_nested = event_stats.nested;
+
+    event_stats.nested = 0;
+    event_stats.depth++;
+
+    gint64 start = g_get_monotonic_time();
+
+    event_dispatch(event);
+
+    gint64 total = g_get_monotonic_time() - start;
+    /* Events handled from within this one, like in the selection wait loop,
+     * are only accounted on their own */
+    gint64 elapsed = total - event_stats.nested;
+
+    if(--event_stats.depth)
+        event_stats.nested = outer_nested + total;
+    else
+        event_stats.nested = 0;
+
+    histogram_add(&event_stats.types[response_type], elapsed);
+
+    if(response_type == XCB_PROPERTY_NOTIFY)
+        histogram_add(event_stats_atom_histogram(&event_stats.properties,
+                                                 ((xcb_property_notify_event_t *) event)->atom),
+                      elapsed);
+}
+
+/** Get the name of an event type.
+ * \param response_type The event type.
+ * \param buf A buffer for names of unknown types.
+ * \param len The size of the buffer.
+ * \return The name.
+ */
+static const char *
+event_stats_type_name(uint8_t response_type, char *buf, size_t len)
+{
+    const char *name;
+
+    if(response_type == 0)
+        return "Error";
+    if(response_type < XCB_MAPPING_NOTIFY + 1
+       && (name = xcb_event_get_label(response_type)))
+        return name;
+
+    snprintf(buf, len, "Event%d", response_type);
+    return buf;
+}
+
+/** Get the name of an atom, synchronously.
+ * \param atom The atom.
+ * \return A newly allocated name, to be freed with p_delete().
+ */
+static char *
+event_stats_atom_name(xcb_atom_t atom)
+{
+    xcb_get_atom_name_reply_t *reply =
+        xcb_get_atom_name_reply(globalconf.connection,
+                                xcb_get_atom_name_unchecked(globalconf.connection, atom),
+                                NULL);
+    char *name;
+
+    if(reply)
+    {
+        int len = xcb_get_atom_name_name_length(reply);
+        name = p_new(char, len + 1);
+        memcpy(name, xcb_get_atom_name_name(reply), len);
+        name[len] = '\0';
+        p_delete(&reply);
+    }
+    else
+    {
+        name = p_new(char, 16);
+        snprintf(name, 16, "%u", atom);
+    }
+
+    return name;
+}
+
+/** Push a table with the histograms of some atoms, keyed by atom name.
+ * \param L The Lua VM state.
+ * \param table The per atom histograms, or NULL.
+ */
+static void
+event_stats_atoms_push(lua_State *L, GHashTable *table)
+{
+    lua_newtable(L);
+    if(table)
+    {
+        GHashTableIter iter;
+        gpointer atom, h;
+
+        g_hash_table_iter_init(&iter, table);
+        while(g_hash_table_iter_next(&iter, &atom, &h))
+        {
+            char *name = event_stats_atom_name(GPOINTER_TO_UINT(atom));
+            luaA_histogram_push(L, h);
+            lua_setfield(L, -2, name);
+            p_delete(&name);
+        }
+    }
+}
+
+/** Print the histograms of some atoms.
+ * \param out The stream to print to.
+ * \param table The per atom histograms, or NULL.
+ * \param prefix The label prefix, followed by the atom name.
+ */
+static void
+event_stats_atoms_print(FILE *out, GHashTable *table, const char *prefix)
+{
+    if(table)
+    {
+        GHashTableIter iter;
+        gpointer atom, h;
+
+        g_hash_table_iter_init(&iter, table);
+        while(g_hash_table_iter_next(&iter, &atom, &h))
+        {
+            char *name = event_stats_atom_name(GPOINTER_TO_UINT(atom));
+            char *label = p_new(char, a_strlen(prefix) + a_strlen(name) + 2);
+            sprintf(label, "%s %s", prefix, name);
+            histogram_print(out, label, h);
+            p_delete(&label);
+            p_delete(&name);
+        }
+    }
+}
+
+/** Get statistics about event handling.
+ * \param L The Lua VM state.
+ * \return The number of elements pushed on stack.
+ * \luastack
+ * \lreturn A table with a latency histogram per event type name, the
+ * histograms of PropertyNotify events per atom name in the properties field,
+ * the histograms of the property reply handling per atom name in the
+ * property_updates field and the number of events dropped by coalescing in
+ * the coalesced field.
+ */
+int
+luaA_event_stats(lua_State *L)
+{
+    char buf[16];
+
+    lua_newtable(L);
+
+    for(int i = 0; i < countof(event_stats.types); i++)
+        if(event_stats.types[i].count)
+        {
+            luaA_histogram_push(L, &event_stats.types[i]);
+            lua_setfield(L, -2, event_stats_type_name(i, buf, sizeof(buf)));
+        }
+
+    event_stats_atoms_push(L, event_stats.properties);
+    lua_setfield(L, -2, "properties");
+
+    event_stats_atoms_push(L, event_stats.property_updates);
+    lua_setfield(L, -2, "property_updates");
+
+    lua_newtable(L);
+    lua_pushnumber(L, globalconf.coalesced.motionnotify);
+    lua_setfield(L, -2, "MotionNotify");
+    lua_pushnumber(L, globalconf.coalesced.propertynotify);
+    lua_setfield(L, -2, "PropertyNotify");
+    lua_pushnumber(L, globalconf.coalesced.configurerequest);
+    lua_setfield(L, -2, "ConfigureRequest");
+    lua_pushnumber(L, globalconf.coalesced.expose);
+    lua_setfield(L, -2, "Expose");
+    lua_setfield(L, -2, "coalesced");
+
+    return 1;
+}
+
+/** Print statistics about event handling.
+ * \param out The stream to print to.
+ */
+void
+event_stats_print(FILE *out)
+{
+    char buf[16];
+
+    fprintf(out, "Event handling latencies, buckets are powers of two of microseconds:\n");
+    for(int i = 0; i < countof(event_stats.types); i++)
+        histogram_print(out, event_stats_type_name(i, buf, sizeof(buf)), &event_stats.types[i]);
+
+    event_stats_atoms_print(out, event_stats.properties, "PropertyNotify");
+    event_stats_atoms_print(out, event_stats.property_updates, "Property update");
+
+    fprintf(out, "Coalesced events: MotionNotify %u, PropertyNotify %u, "
+            "ConfigureRequest %u, Expose %u\n",
+            globalconf.coalesced.motionnotify, globalconf.coalesced.propertynotify,
+            globalconf.coalesced.configurerequest, globalconf.coalesced.expose);
+}
+
+/** Account the iteration that just finished and start a new one.
+ * \return The sample of the new iteration.
+ */
+refresh_sample_t *
+refresh_stats_next(void)
+{
+    refresh_sample_t *sample;
+
+    if(refresh_stats.iterations)
+    {
+        sample = refresh_stats_current();
+        for(int i = 0; i < REFRESH_PHASE_COUNT; i++)
+            histogram_add(&refresh_stats.phases[i], sample->usec[i]);
+    }
+
+    refresh_stats.iterations++;
+    sample = refresh_stats_current();
+    p_clear(sample, 1);
+
+    return sample;
+}
+
+/** Account a refresh done from within a main loop iteration, which is not
+ * recorded as an iteration of its own.
+ */
+void
+refresh_stats_nested(void)
+{
+    refresh_stats.nested++;
+}
+
+/** Get the sample of the current main loop iteration.
+ * \return The sample.
+ */
+refresh_sample_t *
+refresh_stats_current(void)
+{
+    return &refresh_stats.samples[(refresh_stats.iterations + REFRESH_STATS_LEN - 1)
+                                  % REFRESH_STATS_LEN];
+}
+
+/** Get the time spent in each phase of the last main loop iterations.
+ * \param L The Lua VM state.
+ * \return The number of elements pushed on stack.
+ * \luastack
+ * \lreturn An array of tables, oldest iteration first, with the time in
+ * seconds spent in each phase.
+ */
+int
+luaA_refresh_stats(lua_State *L)
+{
+    unsigned int len = MIN(refresh_stats.iterations, REFRESH_STATS_LEN);
+
+    lua_createtable(L, len, 0);
+
+    for(unsigned int i = 0; i < len; i++)
+    {
+        refresh_sample_t *sample =
+            &refresh_stats.samples[(refresh_stats.iterations - len + i) % REFRESH_STATS_LEN];
+
+        lua_createtable(L, 0, REFRESH_PHASE_COUNT);
+        for(int phase = 0; phase < REFRESH_PHASE_COUNT; phase++)
+        {
+            lua_pushnumber(L, sample->usec[phase] / 1e6);
+            lua_setfield(L, -2, refresh_phase_names[phase]);
+        }
+        lua_rawseti(L, -2, i + 1);
+    }
+
+    return 1;
+}
+
+/** Print a summary of the time spent in each main loop phase.
+ * \param out The stream to print to.
+ */
+void
+refresh_stats_print(FILE *out)
+{
+    fprintf(out, "Main loop phase latencies over %u iterations (%u nested refreshes "
+            "not included), buckets are powers of two of microseconds:\n",
+            refresh_stats.iterations, refresh_stats.nested);
+    for(int i = 0; i < REFRESH_PHASE_COUNT; i++)
+        histogram_print(out, refresh_phase_names[i], &refresh_stats.phases[i]);
+}
+
 // vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -23,21 +23,109 @@
 #define AWESOME_EVENT_H
 
 #include "objects/client.h"
+#include "property.h"
+#include "common/array.h"
+
+DO_ARRAY(xcb_generic_event_t *, event, p_delete)
+
+/** Main loop phases accounted by the refresh statistics */
+typedef enum
+{
+    REFRESH_PHASE_PROPERTY,
+    REFRESH_PHASE_LUA,
+    REFRESH_PHASE_BANNING,
+    REFRESH_PHASE_STACK,
+    REFRESH_PHASE_FOCUS,
+    REFRESH_PHASE_FLUSH,
+    REFRESH_PHASE_POLL,
+    REFRESH_PHASE_EVENTS,
+    /* This is not a valid value, but the number of valid values */
+    REFRESH_PHASE_COUNT
+} refresh_phase_t;
+
+/** Time spent in each phase of one main loop iteration, in microseconds */
+typedef struct
+{
+    uint64_t usec[REFRESH_PHASE_COUNT];
+} refresh_sample_t;
+
+refresh_sample_t * refresh_stats_next(void);
+refresh_sample_t * refresh_stats_current(void);
+void refresh_stats_nested(void);
+int luaA_refresh_stats(lua_State *);
+void refresh_stats_print(FILE *);
+
+/** Account the time spent in a main loop phase.
+ * \param sample The sample of the current iteration.
+ * \param phase The phase which just ended.
+ * \param start The time the phase started.
+ * \return The current time.
+ */
+static inline gint64
+refresh_phase_end(refresh_sample_t *sample, refresh_phase_t phase, gint64 start)
+{
+    gint64 now = g_get_monotonic_time();
+    sample->usec[phase] = now - start;
+    return now;
+}
 
 /* luaa.c */
 void luaA_emit_refresh(void);
 
+/** Apply all the pending changes.
+ * \param sample Where to account the time spent in each phase.
+ * \return The xcb_flush() result.
+ */
 static inline int
-awesome_refresh(void)
+awesome_refresh_sample(refresh_sample_t *sample)
 {
+    gint64 t = g_get_monotonic_time();
+    int ret;
+
+    property_refresh();
+    t = refresh_phase_end(sample, REFRESH_PHASE_PROPERTY, t);
+    /* Ignore the enter and leave events once for all the windows moved,
+     * mapped or unmapped by the refresh */
+    client_enterleave_batch_begin();
     luaA_emit_refresh();
+    t = refresh_phase_end(sample, REFRESH_PHASE_LUA, t);
     banning_refresh();
+    t = refresh_phase_end(sample, REFRESH_PHASE_BANNING, t);
     stack_refresh();
+    t = refresh_phase_end(sample, REFRESH_PHASE_STACK, t);
     client_focus_refresh();
-    return xcb_flush(globalconf.connection);
+    client_enterleave_batch_end();
+    t = refresh_phase_end(sample, REFRESH_PHASE_FOCUS, t);
+    ret = xcb_flush(globalconf.connection);
+    refresh_phase_end(sample, REFRESH_PHASE_FLUSH, t);
+
+    return ret;
+}
+
+/** Apply all the pending changes at the end of a main loop iteration. */
+static inline int
+awesome_refresh(void)
+{
+    return awesome_refresh_sample(refresh_stats_next());
+}
+
+/** Apply all the pending changes from within a main loop iteration, for
+ * example while waiting for a reply. It is not recorded as an iteration.
+ */
+static inline int
+awesome_refresh_nested(void)
+{
+    refresh_sample_t sample;
+
+    refresh_stats_nested();
+    return awesome_refresh_sample(&sample);
 }
 
 void event_handle(xcb_generic_event_t *event);
+void event_stats_property_update(xcb_atom_t, gint64);
+void event_coalesce(event_array_t *);
+int luaA_event_stats(lua_State *);
+void event_stats_print(FILE *);
 
 #endif
 // vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -391,7 +391,10 @@ ewmh_process_client_message(xcb_client_message_event_t *ev)
         if((c = client_getbywin(ev->window)))
         {
             if(ev->data.data32[0] == 0xffffffff)
+            {
                 c->sticky = true;
+                banning_client_update(c);
+            }
             else
                 for(int i = 0; i < globalconf.tags.len; i++)
                     if((int)ev->data.data32[0] == i)
@@ -486,31 +489,54 @@ ewmh_update_window_type(xcb_window_t window, uint32_t type)
                         window, _NET_WM_WINDOW_TYPE, XCB_ATOM_ATOM, 32, 1, &type);
 }
 
+/** Send the requests for the EWMH hints of a window.
+ * \param window The window.
+ * \return The cookies associated with the requests.
+ */
+ewmh_client_hints_cookie_t
+ewmh_client_hints_get_unchecked(xcb_window_t window)
+{
+    ewmh_client_hints_cookie_t cookie;
+
+    cookie.desktop = xcb_get_property_unchecked(globalconf.connection, false, window,
+                                                _NET_WM_DESKTOP, XCB_GET_PROPERTY_TYPE_ANY, 0, 1);
+
+    cookie.state = xcb_get_property_unchecked(globalconf.connection, false, window,
+                                              _NET_WM_STATE, XCB_ATOM_ATOM, 0, UINT32_MAX);
+
+    cookie.window_type = xcb_get_property_unchecked(globalconf.connection, false, window,
+                                                    _NET_WM_WINDOW_TYPE, XCB_ATOM_ATOM, 0, UINT32_MAX);
+
+    return cookie;
+}
+
 void
 ewmh_client_check_hints(client_t *c)
+{
+    ewmh_client_hints_get_reply(c, ewmh_client_hints_get_unchecked(c->window));
+}
+
+/** Process the replies to the EWMH hints requests of a client.
+ * \param c The client.
+ * \param cookie The cookies returned by ewmh_client_hints_get_unchecked().
+ */
+void
+ewmh_client_hints_get_reply(client_t *c, ewmh_client_hints_cookie_t cookie)
 {
     xcb_atom_t *state;
     void *data = NULL;
     int desktop;
-    xcb_get_property_cookie_t c0, c1, c2;
     xcb_get_property_reply_t *reply;
 
-    /* Send the GetProperty requests which will be processed later */
-    c0 = xcb_get_property_unchecked(globalconf.connection, false, c->window,
-                                    _NET_WM_DESKTOP, XCB_GET_PROPERTY_TYPE_ANY, 0, 1);
-
-    c1 = xcb_get_property_unchecked(globalconf.connection, false, c->window,
-                                    _NET_WM_STATE, XCB_ATOM_ATOM, 0, UINT32_MAX);
-
-    c2 = xcb_get_property_unchecked(globalconf.connection, false, c->window,
-                                    _NET_WM_WINDOW_TYPE, XCB_ATOM_ATOM, 0, UINT32_MAX);
-
-    reply = xcb_get_property_reply(globalconf.connection, c0, NULL);
+    reply = xcb_get_property_reply(globalconf.connection, cookie.desktop, NULL);
     if(reply && reply->value_len && (data = xcb_get_property_value(reply)))
     {
         desktop = *(uint32_t *) data;
         if(desktop == -1)
+        {
             c->sticky = true;
+            banning_client_update(c);
+        }
         else if (desktop >= 0 && desktop < globalconf.tags.len)
             for(int i = 0; i < globalconf.tags.len; i++)
                 if(desktop == i)
@@ -531,7 +557,7 @@ ewmh_client_check_hints(client_t *c)
 
     p_delete(&reply);
 
-    reply = xcb_get_property_reply(globalconf.connection, c1, NULL);
+    reply = xcb_get_property_reply(globalconf.connection, cookie.state, NULL);
     if(reply && (data = xcb_get_property_value(reply)))
     {
         state = (xcb_atom_t *) data;
@@ -541,7 +567,7 @@ ewmh_client_check_hints(client_t *c)
 
     p_delete(&reply);
 
-    reply = xcb_get_property_reply(globalconf.connection, c2, NULL);
+    reply = xcb_get_property_reply(globalconf.connection, cookie.window_type, NULL);
     if(reply && (data = xcb_get_property_value(reply)))
     {
         state = (xcb_atom_t *) data;
@@ -567,16 +593,34 @@ ewmh_client_check_hints(client_t *c)
 
 /** Process the WM strut of a client.
  * \param c The client.
- * \param strut_r (Optional) An existing reply.
  */
 void
 ewmh_process_client_strut(client_t *c)
+{
+    ewmh_client_strut_get_reply(c, ewmh_client_strut_get_unchecked(c->window));
+}
+
+/** Send the request for the WM strut of a window.
+ * \param window The window.
+ * \return The cookie associated with the request.
+ */
+xcb_get_property_cookie_t
+ewmh_client_strut_get_unchecked(xcb_window_t window)
+{
+    return xcb_get_property_unchecked(globalconf.connection, false, window,
+                                      _NET_WM_STRUT_PARTIAL, XCB_ATOM_CARDINAL, 0, 12);
+}
+
+/** Process the reply to the WM strut request of a client.
+ * \param c The client.
+ * \param strut_q The cookie returned by ewmh_client_strut_get_unchecked().
+ */
+void
+ewmh_client_strut_get_reply(client_t *c, xcb_get_property_cookie_t strut_q)
 {
     void *data;
     xcb_get_property_reply_t *strut_r;
 
-    xcb_get_property_cookie_t strut_q = xcb_get_property_unchecked(globalconf.connection, false, c->window,
-                                                                   _NET_WM_STRUT_PARTIAL, XCB_ATOM_CARDINAL, 0, 12);
     strut_r = xcb_get_property_reply(globalconf.connection, strut_q, NULL);
 
     if(strut_r
@@ -612,7 +656,7 @@ ewmh_process_client_strut(client_t *c)
             c->strut.bottom_end_x = strut[11];
 
             luaA_object_push(globalconf.L, c);
-            luaA_object_emit_signal(globalconf.L, -1, "property::struts", 0);
+            luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_struts, 0);
             lua_pop(globalconf.L, 1);
         }
     }
@@ -631,7 +675,12 @@ ewmh_window_icon_get_unchecked(xcb_window_t w)
                                     _NET_WM_ICON, XCB_ATOM_CARDINAL, 0, UINT32_MAX);
 }
 
-static cairo_surface_t *
+/** Decode a NET_WM_ICON reply. This does not use the X connection nor Lua and
+ * can thus be called from any thread.
+ * \param r The reply.
+ * \return The icon or NULL.
+ */
+cairo_surface_t *
 ewmh_window_icon_from_reply(xcb_get_property_reply_t *r)
 {
     uint32_t *data;
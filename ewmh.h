@@ -27,6 +27,14 @@
 #include "globalconf.h"
 #include "strut.h"
 
+/** Cookies of the EWMH hints requests of a window */
+typedef struct
+{
+    xcb_get_property_cookie_t desktop;
+    xcb_get_property_cookie_t state;
+    xcb_get_property_cookie_t window_type;
+} ewmh_client_hints_cookie_t;
+
 void ewmh_init(void);
 void ewmh_update_net_numbers_of_desktop(void);
 void ewmh_update_net_current_desktop(void);
@@ -34,12 +42,17 @@ void ewmh_update_net_desktop_names(void);
 int ewmh_process_client_message(xcb_client_message_event_t *);
 void ewmh_update_net_client_list_stacking(void);
 void ewmh_client_check_hints(client_t *);
+ewmh_client_hints_cookie_t ewmh_client_hints_get_unchecked(xcb_window_t);
+void ewmh_client_hints_get_reply(client_t *, ewmh_client_hints_cookie_t);
 void ewmh_client_update_desktop(client_t *);
 void ewmh_process_client_strut(client_t *);
+xcb_get_property_cookie_t ewmh_client_strut_get_unchecked(xcb_window_t);
+void ewmh_client_strut_get_reply(client_t *, xcb_get_property_cookie_t);
 void ewmh_update_strut(xcb_window_t, strut_t *);
 void ewmh_update_window_type(xcb_window_t window, uint32_t type);
 xcb_get_property_cookie_t ewmh_window_icon_get_unchecked(xcb_window_t);
 cairo_surface_t *ewmh_window_icon_get_reply(xcb_get_property_cookie_t);
+cairo_surface_t *ewmh_window_icon_from_reply(xcb_get_property_reply_t *);
 
 #endif
 // vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -34,6 +34,7 @@
 #include "color.h"
 #include "common/xembed.h"
 #include "common/buffer.h"
+#include "common/bitset.h"
 
 #define ROOT_WINDOW_EVENT_MASK \
     (const uint32_t []) { \
@@ -133,10 +134,20 @@ typedef struct
     uint8_t default_depth;
     /** Our default color map */
     xcb_colormap_t default_cmap;
-    /** Do we have to reban clients? */
-    bool need_lazy_banning;
+    /** Clients whose visibility changed and which have to be rebanned */
+    client_array_t banning;
     /** Tag list */
     tag_array_t tags;
+    /** Slots of the selected tags which are activated */
+    bitset_t tags_selected;
+    /** Number of events dropped because a later one superseded them */
+    struct
+    {
+        unsigned int motionnotify;
+        unsigned int propertynotify;
+        unsigned int configurerequest;
+        unsigned int expose;
+    } coalesced;
 } awesome_t;
 
 extern awesome_t globalconf;
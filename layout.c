@@ -0,0 +1,579 @@
+/*
+ * layout.c - client tiling layouts
+ *
+ * Copyright © 2014 awesome developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+/* These are the tile, fair, spiral, max and magnifier layouts of
+ * lib/awful/layout/suit, computing the geometry of each client into an array
+ * instead of resizing the clients one by one. They do the same floating point
+ * operations in the same order as the Lua layouts, and the geometry asked for
+ * is converted to area_t like c:geometry() does, so that both produce the
+ * same geometries. */
+
+#include <math.h>
+
+#include "layout.h"
+#include "luaa.h"
+
+/** Build the geometry asked for a client.
+ * The values are truncated like the ones given to c:geometry().
+ * \param x The x coordinate.
+ * \param y The y coordinate.
+ * \param width The width.
+ * \param height The height.
+ * \return The geometry.
+ */
+static inline area_t
+layout_area(double x, double y, double width, double height)
+{
+    area_t area;
+
+    area.x = x;
+    area.y = y;
+    area.width = width;
+    area.height = height;
+
+    return area;
+}
+
+/** Get the size hint the tile layout makes room for.
+ * \param c The client.
+ * \param swap True to get the height instead of the width.
+ * \return The minimum size, or the base size, or 0.
+ */
+static double
+layout_tile_size_hint(client_t *c, bool swap)
+{
+    if(c->size_hints.flags & XCB_ICCCM_SIZE_HINT_P_MIN_SIZE)
+        return swap ? c->size_hints.min_height : c->size_hints.min_width;
+    if(c->size_hints.flags & XCB_ICCCM_SIZE_HINT_BASE_SIZE)
+        return swap ? c->size_hints.base_height : c->size_hints.base_width;
+    return 0;
+}
+
+/** Tile a column of clients.
+ * Coordinates are the ones of a right tile layout, swapped for the top and
+ * bottom ones.
+ * \param clients The clients.
+ * \param result The geometries asked for the clients.
+ * \param swap True to swap the x and y coordinates.
+ * \param wa The work area, x, y, width and height.
+ * \param fact The window factors of the column.
+ * \param first The index of the first client of the column.
+ * \param last The index of the last client of the column.
+ * \param coord The x coordinate of the column.
+ * \param size The width of the column.
+ * \return The width used by the column.
+ */
+static double
+layout_tile_group(client_t **clients, area_t *result, bool swap,
+                  const double wa[4], double *fact,
+                  int first, int last, double coord, double size)
+{
+    double available = wa[2] - (coord - wa[0]);
+    double total_fact = 0, min_fact = 1;
+
+    for(int c = first; c <= last; c++)
+    {
+        int i = c - first;
+        double size_hint = layout_tile_size_hint(clients[c], swap)
+            + clients[c]->border_width * 2;
+        size = MAX(size_hint, size);
+
+        if(!fact[i])
+            fact[i] = min_fact;
+        else
+            min_fact = MIN(fact[i], min_fact);
+        total_fact += fact[i];
+    }
+    size = MIN(size, available);
+
+    double y = wa[1], used_size = 0, unused = wa[3];
+
+    for(int c = first; c <= last; c++)
+    {
+        int i = c - first;
+        double border = clients[c]->border_width * 2;
+        double width = size - border;
+        double height = floor(unused * fact[i] / total_fact) - border;
+
+        if(swap)
+            result[c] = layout_area(y, coord, height, width);
+        else
+            result[c] = layout_area(coord, y, width, height);
+
+        /* The next clients are placed after the geometry this one gets */
+        area_t geometry = client_geometry_request(clients[c], result[c]);
+        width = swap ? geometry.height : geometry.width;
+        height = swap ? geometry.width : geometry.height;
+
+        y = y + height + border;
+        unused = unused - height - border;
+        total_fact = total_fact - fact[i];
+        used_size = MAX(used_size, width + border);
+    }
+
+    return used_size;
+}
+
+/** Compute the tile layouts.
+ * \param clients The clients.
+ * \param count The number of clients.
+ * \param workarea The area to tile.
+ * \param orientation Where the master clients are.
+ * \param mwfact The master width factor.
+ * \param nmaster The number of master clients.
+ * \param ncol The number of columns of other clients.
+ * \param facts The window factors, filled with the missing ones.
+ * \param result The geometries asked for the clients.
+ */
+void
+layout_tile(client_t **clients, int count, area_t workarea,
+            layout_tile_orientation_t orientation,
+            double mwfact, int nmaster, int ncol,
+            layout_tile_facts_t *facts, area_t *result)
+{
+    bool swap = orientation == LAYOUT_TILE_BOTTOM || orientation == LAYOUT_TILE_TOP;
+    bool before = orientation == LAYOUT_TILE_LEFT || orientation == LAYOUT_TILE_TOP;
+    double wa[4];
+
+    if(swap)
+    {
+        wa[0] = workarea.y;
+        wa[1] = workarea.x;
+        wa[2] = workarea.height;
+        wa[3] = workarea.width;
+    }
+    else
+    {
+        wa[0] = workarea.x;
+        wa[1] = workarea.y;
+        wa[2] = workarea.width;
+        wa[3] = workarea.height;
+    }
+
+    nmaster = MIN(nmaster, count);
+    int nother = MAX(count - nmaster, 0);
+
+    for(int i = 0; i <= ncol; i++)
+        facts->len[i] = -1;
+
+    double coord = wa[0];
+    /* On the left or top, the other clients are placed first */
+    bool place_master = !before;
+
+    for(int d = 0; d < 2; d++)
+    {
+        if(place_master && nmaster > 0)
+        {
+            double size = wa[2];
+            if(nother > 0)
+                size = MIN(wa[2] * mwfact, wa[2] - (coord - wa[0]));
+            facts->len[0] = nmaster;
+            coord = coord + layout_tile_group(clients, result, swap, wa, facts->facts[0],
+                                              0, nmaster - 1, coord, size);
+        }
+
+        if(!place_master && nother > 0)
+        {
+            int last = nmaster;
+
+            double wasize = wa[2];
+            if(nmaster > 0 && before)
+                wasize = wa[2] - wa[2] * mwfact;
+            for(int i = 1; i <= ncol; i++)
+            {
+                /* Try to get equal width among remaining columns */
+                double size = (wasize - (coord - wa[0])) / (ncol - i + 1);
+                int first = last + 1;
+                last = last + floor((double) (count - last) / (ncol - i + 1));
+                facts->len[i] = last - first + 1;
+                coord = coord + layout_tile_group(clients, result, swap, wa, facts->facts[i],
+                                                  first - 1, last - 1, coord, size);
+            }
+        }
+        place_master = !place_master;
+    }
+}
+
+/** Compute the fair layouts.
+ * \param clients The clients.
+ * \param count The number of clients.
+ * \param workarea The area to fill.
+ * \param horizontal True for the horizontal layout.
+ * \param result The geometries asked for the clients.
+ */
+void
+layout_fair(client_t **clients, int count, area_t workarea, bool horizontal,
+            area_t *result)
+{
+    double wx = workarea.x, wy = workarea.y;
+    double width = workarea.width, height = workarea.height;
+    double rows, cols;
+
+    if(horizontal)
+    {
+        wx = workarea.y;
+        wy = workarea.x;
+        width = workarea.height;
+        height = workarea.width;
+    }
+
+    if(!count)
+        return;
+
+    if(count == 2)
+    {
+        rows = 1;
+        cols = 2;
+    }
+    else
+    {
+        rows = ceil(sqrt(count));
+        cols = ceil(count / rows);
+    }
+
+    for(int k = 0; k < count; k++)
+    {
+        double row = fmod(k, rows);
+        double col = floor(k / rows);
+        double lrows = rows, lcols = cols;
+        double gx, gy, gwidth, gheight;
+
+        if(k >= rows * cols - rows)
+            lrows = count - (rows * cols - rows);
+
+        if(row == lrows - 1)
+        {
+            gheight = height - ceil(height / lrows) * row;
+            gy = height - gheight;
+        }
+        else
+        {
+            gheight = ceil(height / lrows);
+            gy = gheight * row;
+        }
+
+        if(col == lcols - 1)
+        {
+            gwidth = width - ceil(width / lcols) * col;
+            gx = width - gwidth;
+        }
+        else
+        {
+            gwidth = ceil(width / lcols);
+            gx = gwidth * col;
+        }
+
+        gheight = gheight - clients[k]->border_width * 2;
+        gwidth = gwidth - clients[k]->border_width * 2;
+        gy = gy + wy;
+        gx = gx + wx;
+
+        if(horizontal)
+            result[k] = layout_area(gy, gx, gheight, gwidth);
+        else
+            result[k] = layout_area(gx, gy, gwidth, gheight);
+    }
+}
+
+/** Compute the spiral and dwindle layouts.
+ * \param clients The clients.
+ * \param count The number of clients.
+ * \param workarea The area to fill.
+ * \param spiral True for the spiral layout, false for the dwindle one.
+ * \param result The geometries asked for the clients.
+ */
+void
+layout_spiral(client_t **clients, int count, area_t workarea, bool spiral,
+              area_t *result)
+{
+    double x = workarea.x, y = workarea.y;
+    double width = workarea.width, height = workarea.height;
+
+    for(int k = 1; k <= count; k++)
+    {
+        client_t *c = clients[k - 1];
+
+        if(k < count)
+        {
+            if(k % 2 == 0)
+                height = height / 2;
+            else
+                width = width / 2;
+        }
+
+        if(k % 4 == 0 && spiral)
+            x = x - width;
+        else if(k % 2 == 0 || (k % 4 == 3 && k < count && spiral))
+            x = x + width;
+
+        if(k % 4 == 1 && k != 1 && spiral)
+            y = y - height;
+        else if((k % 2 == 1 && k != 1) || (k % 4 == 0 && k < count && spiral))
+            y = y + height;
+
+        result[k - 1] = layout_area(x, y,
+                                    width - 2 * c->border_width,
+                                    height - 2 * c->border_width);
+    }
+}
+
+/** Compute the max and fullscreen layouts.
+ * \param clients The clients.
+ * \param count The number of clients.
+ * \param area The area to fill, the work area or the screen geometry.
+ * \param result The geometries asked for the clients.
+ */
+void
+layout_max(client_t **clients, int count, area_t area, area_t *result)
+{
+    for(int k = 0; k < count; k++)
+        result[k] = layout_area(area.x, area.y,
+                                (double) area.width - clients[k]->border_width * 2,
+                                (double) area.height - clients[k]->border_width * 2);
+}
+
+/** Compute the magnifier layout.
+ * \param clients The clients.
+ * \param count The number of clients, at least one.
+ * \param area The area to fill.
+ * \param mwfact The master width factor.
+ * \param focus The index of the magnified client.
+ * \param result The geometries asked for the clients.
+ */
+void
+layout_magnifier(client_t **clients, int count, area_t area, double mwfact,
+                 int focus, area_t *result)
+{
+    double x = area.x, y = area.y, width = area.width, height = area.height;
+
+    if(count > 1)
+    {
+        width = area.width * sqrt(mwfact);
+        height = area.height * sqrt(mwfact);
+        x = area.x + (area.width - width) / 2;
+        y = area.y + (area.height - height) / 2;
+    }
+
+    result[focus] = layout_area(x, y,
+                                width - clients[focus]->border_width * 2,
+                                height - clients[focus]->border_width * 2);
+
+    if(count > 1)
+    {
+        x = area.x;
+        y = area.y;
+        height = (double) area.height / (count - 1);
+        width = area.width;
+
+        /* First the clients after the magnified one, as is */
+        for(int k = focus + 1; k < count; k++)
+        {
+            result[k] = layout_area(x, y, width, height);
+            y = y + height;
+        }
+
+        /* Then the clients before it */
+        for(int k = 0; k < focus; k++)
+        {
+            result[k] = layout_area(x, y,
+                                    width - clients[k]->border_width * 2,
+                                    height - clients[k]->border_width * 2);
+            y = y + height;
+        }
+    }
+}
+
+/** Read the window factors of the tile layout.
+ * \param L The Lua VM state.
+ * \param idx The index of the windowfact table of the tag.
+ * \param facts The factors to fill.
+ * \param ncol The number of columns.
+ * \param count The number of clients.
+ */
+static void
+luaA_layout_tile_facts_get(lua_State *L, int idx, layout_tile_facts_t *facts,
+                           int ncol, int count)
+{
+    for(int g = 0; g <= ncol; g++)
+    {
+        lua_rawgeti(L, idx, g);
+        if(lua_istable(L, -1))
+            for(int i = 0; i < count; i++)
+            {
+                lua_rawgeti(L, -1, i + 1);
+                facts->facts[g][i] = lua_tonumber(L, -1);
+                lua_pop(L, 1);
+            }
+        lua_pop(L, 1);
+    }
+}
+
+/** Store the window factors of the tile layout, with the ones it set.
+ * \param L The Lua VM state.
+ * \param idx The index of the windowfact table of the tag.
+ * \param facts The factors.
+ * \param ncol The number of columns.
+ */
+static void
+luaA_layout_tile_facts_set(lua_State *L, int idx, layout_tile_facts_t *facts,
+                           int ncol)
+{
+    for(int g = 0; g <= ncol; g++)
+    {
+        if(facts->len[g] < 0)
+            continue;
+
+        lua_rawgeti(L, idx, g);
+        if(!lua_istable(L, -1))
+        {
+            lua_pop(L, 1);
+            lua_newtable(L);
+            lua_pushvalue(L, -1);
+            lua_rawseti(L, idx, g);
+        }
+        for(int i = 0; i < facts->len[g]; i++)
+        {
+            lua_pushnumber(L, facts->facts[g][i]);
+            lua_rawseti(L, -2, i + 1);
+        }
+        lua_pop(L, 1);
+    }
+}
+
+/** Compute the geometries of a layout.
+ * \param L The Lua VM state.
+ * \return The number of elements pushed on stack.
+ * \luastack
+ * \lparam The layout name: tile, fair, spiral, max or magnifier.
+ * \lparam The clients to arrange.
+ * \lparam The area to arrange them in.
+ * \lparam A table with the layout parameters: orientation, mwfact, nmaster,
+ * ncol and windowfact for tile, horizontal for fair, spiral for spiral and
+ * mwfact and focus for magnifier.
+ * \lreturn A table with the geometry to give to each client, or nothing if the
+ * layout is unknown.
+ */
+int
+luaA_layout_kernel(lua_State *L)
+{
+    const char *name = luaL_checkstring(L, 1);
+    luaA_checktable(L, 2);
+    luaA_checktable(L, 3);
+    if(lua_isnoneornil(L, 4))
+    {
+        lua_settop(L, 3);
+        lua_newtable(L);
+    }
+    luaA_checktable(L, 4);
+
+    area_t area = {
+        .x = luaA_getopt_number(L, 3, "x", 0),
+        .y = luaA_getopt_number(L, 3, "y", 0),
+        .width = luaA_getopt_number(L, 3, "width", 0),
+        .height = luaA_getopt_number(L, 3, "height", 0)
+    };
+
+    int count = luaA_rawlen(L, 2);
+    /* The arrays are userdata so that they are collected if an argument is
+     * wrong */
+    client_t **clients = lua_newuserdata(L, sizeof(client_t *) * MAX(count, 1));
+    area_t *result = lua_newuserdata(L, sizeof(area_t) * MAX(count, 1));
+    bool known = true;
+
+    p_clear(result, MAX(count, 1));
+
+    for(int i = 0; i < count; i++)
+    {
+        lua_rawgeti(L, 2, i + 1);
+        clients[i] = luaA_toudata(L, -1, &client_class);
+        lua_pop(L, 1);
+        if(!clients[i])
+            luaL_error(L, "invalid client at index %d", i + 1);
+    }
+
+    if(A_STREQ(name, "tile"))
+    {
+        const char *orientation = luaA_getopt_lstring(L, 4, "orientation", "right", NULL);
+        layout_tile_orientation_t o = LAYOUT_TILE_RIGHT;
+        int ncol = MAX(luaA_getopt_number(L, 4, "ncol", 1), 0);
+        layout_tile_facts_t facts;
+
+        if(A_STREQ(orientation, "left"))
+            o = LAYOUT_TILE_LEFT;
+        else if(A_STREQ(orientation, "bottom"))
+            o = LAYOUT_TILE_BOTTOM;
+        else if(A_STREQ(orientation, "top"))
+            o = LAYOUT_TILE_TOP;
+
+        facts.facts = lua_newuserdata(L, sizeof(double *) * (ncol + 1));
+        facts.len = lua_newuserdata(L, sizeof(int) * (ncol + 1));
+        double *values = lua_newuserdata(L, sizeof(double) * (ncol + 1) * MAX(count, 1));
+        p_clear(facts.len, ncol + 1);
+        p_clear(values, (ncol + 1) * MAX(count, 1));
+        for(int g = 0; g <= ncol; g++)
+            facts.facts[g] = values + g * MAX(count, 1);
+
+        lua_getfield(L, 4, "windowfact");
+        int windowfact = lua_istable(L, -1) ? lua_gettop(L) : 0;
+        if(windowfact)
+            luaA_layout_tile_facts_get(L, windowfact, &facts, ncol, count);
+
+        layout_tile(clients, count, area, o,
+                    luaA_getopt_number(L, 4, "mwfact", 0.5),
+                    luaA_getopt_number(L, 4, "nmaster", 1),
+                    ncol, &facts, result);
+
+        if(windowfact)
+            luaA_layout_tile_facts_set(L, windowfact, &facts, ncol);
+        lua_pop(L, 1);
+    }
+    else if(A_STREQ(name, "fair"))
+        layout_fair(clients, count, area, luaA_getopt_boolean(L, 4, "horizontal", false), result);
+    else if(A_STREQ(name, "spiral"))
+        layout_spiral(clients, count, area, luaA_getopt_boolean(L, 4, "spiral", true), result);
+    else if(A_STREQ(name, "max"))
+        layout_max(clients, count, area, result);
+    else if(A_STREQ(name, "magnifier"))
+    {
+        int focus = luaA_getopt_number(L, 4, "focus", 1) - 1;
+        if(count > 0 && focus >= 0 && focus < count)
+            layout_magnifier(clients, count, area,
+                             luaA_getopt_number(L, 4, "mwfact", 0.5), focus, result);
+        else
+            known = false;
+    }
+    else
+        known = false;
+
+    if(known)
+    {
+        lua_createtable(L, count, 0);
+        for(int i = 0; i < count; i++)
+        {
+            luaA_pusharea(L, result[i]);
+            lua_rawseti(L, -2, i + 1);
+        }
+    }
+
+    return known ? 1 : 0;
+}
+
+// vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -0,0 +1,58 @@
+/*
+ * layout.h - client tiling layouts header
+ *
+ * Copyright © 2014 awesome developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef AWESOME_LAYOUT_H
+#define AWESOME_LAYOUT_H
+
+#include "objects/client.h"
+
+/** Where the master clients of the tile layout are */
+typedef enum
+{
+    LAYOUT_TILE_RIGHT,
+    LAYOUT_TILE_LEFT,
+    LAYOUT_TILE_BOTTOM,
+    LAYOUT_TILE_TOP
+} layout_tile_orientation_t;
+
+/** Window factors of the tile layout, one array per column.
+ * Column 0 holds the master clients. A factor of 0 is unset, and is set by
+ * layout_tile() like the Lua layout does.
+ */
+typedef struct
+{
+    /** Factors of each column, indexed by the position in the column */
+    double **facts;
+    /** Number of clients in each column, -1 if the column was not visited */
+    int *len;
+} layout_tile_facts_t;
+
+void layout_tile(client_t **, int, area_t, layout_tile_orientation_t,
+                 double, int, int, layout_tile_facts_t *, area_t *);
+void layout_fair(client_t **, int, area_t, bool, area_t *);
+void layout_spiral(client_t **, int, area_t, bool, area_t *);
+void layout_max(client_t **, int, area_t, area_t *);
+void layout_magnifier(client_t **, int, area_t, double, int, area_t *);
+
+int luaA_layout_kernel(lua_State *);
+
+#endif
+// vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -40,12 +40,16 @@
 #include "objects/drawable.h"
 #include "screen.h"
 #include "event.h"
+#include "layout.h"
 #include "selection.h"
 #include "systray.h"
 #include "common/xcursor.h"
 #include "common/buffer.h"
 #include "common/backtrace.h"
 
+/** Maximum number of deferred signals passes per refresh */
+#define REFRESH_PASSES_MAX 3
+
 #ifdef WITH_DBUS
 extern const struct luaL_Reg awesome_dbus_lib[];
 #endif
@@ -438,7 +442,7 @@ luaA_awesome_connect_signal(lua_State *L)
 {
     const char *name = luaL_checkstring(L, 1);
     luaA_checkfunction(L, 2);
-    signal_connect(&global_signals, name, luaA_object_ref(L, 2));
+    signal_connect(&global_signals, name, luaA_function_ref(L, 2));
     return 0;
 }
 
@@ -456,7 +460,7 @@ luaA_awesome_disconnect_signal(lua_State *L)
     luaA_checkfunction(L, 2);
     const void *func = lua_topointer(L, 2);
     signal_disconnect(&global_signals, name, func);
-    luaA_object_unref(L, (void *) func);
+    luaA_function_unref(L, (void *) func);
     return 0;
 }
 
@@ -493,7 +497,7 @@ luaA_dofunction_on_error(lua_State *L)
     /* duplicate string error */
     lua_pushvalue(L, -1);
     /* emit error signal */
-    signal_object_emit(L, &global_signals, "debug::error", 1);
+    signal_object_emit_id(L, &global_signals, SIGNAL_debug_error, 1);
 
     if(!luaL_dostring(L, "return debug.traceback(\"error while running function\", 3)"))
     {
@@ -526,6 +530,12 @@ luaA_init(xdgHandle* xdg)
         { "emit_signal", luaA_awesome_emit_signal },
         { "systray", luaA_systray },
         { "load_image", luaA_load_image },
+        { "event_stats", luaA_event_stats },
+        { "refresh_stats", luaA_refresh_stats },
+        { "signal_stats", luaA_signal_stats },
+        { "enterleave_stats", luaA_enterleave_stats },
+        { "stack_stats", luaA_stack_stats },
+        { "layout_kernel", luaA_layout_kernel },
         { "__index", luaA_awesome_index },
         { NULL, NULL }
     };
@@ -746,21 +756,34 @@ bailout:
 int
 luaA_class_index_miss_property(lua_State *L, lua_object_t *obj)
 {
-    signal_object_emit(L, &global_signals, "debug::index::miss", 2);
+    signal_object_emit_id(L, &global_signals, SIGNAL_debug_index_miss, 2);
     return 0;
 }
 
 int
 luaA_class_newindex_miss_property(lua_State *L, lua_object_t *obj)
 {
-    signal_object_emit(L, &global_signals, "debug::newindex::miss", 3);
+    signal_object_emit_id(L, &global_signals, SIGNAL_debug_newindex_miss, 3);
     return 0;
 }
 
 void
 luaA_emit_refresh()
 {
-    signal_object_emit(globalconf.L, &global_signals, "refresh", 0);
+    /* Handlers of property signals may change properties too. Handlers
+     * changing properties back and forth must not hang the main loop, what is
+     * left after a few passes waits for the next iteration. */
+    int passes = 0;
+    do
+        signal_object_emit_deferred(globalconf.L);
+    while(signal_object_deferred_pending() && ++passes < REFRESH_PASSES_MAX);
+
+    if(signal_object_deferred_pending())
+        signal_stats.postponed++;
+
+    /* Properties changed by the refresh handlers are signaled by the next
+     * refresh, which the main loop runs without waiting */
+    signal_object_emit_id(globalconf.L, &global_signals, SIGNAL_refresh, 0);
 }
 
 // vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -36,7 +36,7 @@
         luaA_warn(L, "%s: This function is deprecated and will be removed, see %s", \
                   __FUNCTION__, repl); \
         lua_pushlstring(L, __FUNCTION__, sizeof(__FUNCTION__)); \
-        signal_object_emit(L, &global_signals, "debug::deprecation", 1); \
+        signal_object_emit_id(L, &global_signals, SIGNAL_debug_deprecation, 1); \
     } while(0)
 
 #define luaA_checkscreen(screen) \
@@ -56,3 +56,72 @@ module("awesome")
 -- @param ... Signal arguments.
 -- @name emit_signal
 -- @class function
+
+--- Get statistics about X event handling. Latencies are kept as log-scale
+-- histograms, tables with the fields count, total and max (in seconds) and
+-- buckets, where buckets[1] counts events handled in less than 1 microsecond
+-- and buckets[i] counts events handled in 2^(i-2) to 2^(i-1) microseconds.
+-- The statistics are also printed on stderr when awesome receives SIGUSR1.
+-- @return A table with a histogram per event type name, a properties table
+-- with a histogram of PropertyNotify events per atom name, a property_updates
+-- table with a histogram of the handling of the property replies, done at the
+-- next refresh, per atom name and a coalesced table with the number of events
+-- dropped by coalescing per event type name.
+-- @name event_stats
+-- @class function
+
+--- Get the time spent in each phase of the last main loop iterations. The
+-- phases are property, lua, banning, stack, focus and flush (the refresh done
+-- before waiting for events), poll (waiting for events) and events (handling
+-- them). A summary is printed on stderr on exit and when awesome receives
+-- SIGUSR1.
+-- @return An array of tables, oldest iteration first, mapping each phase name
+-- to the time spent in it, in seconds.
+-- @name refresh_stats
+-- @class function
+
+--- Get statistics about signal emission. Signals to which no function is
+-- connected, neither on the object nor on its class, are skipped before
+-- calling into Lua.
+-- @return A table with the number of emitted signals in the emitted field,
+-- the number of them which were skipped in the skipped field, the number of
+-- property signals deferred to the next refresh in the deferred field, the
+-- number of them merged into a pending one in the coalesced field and the
+-- number of refreshes which stopped emitting them after a few passes with
+-- signals left for the next one in the postponed field. The refresh signal
+-- itself is emitted once per refresh, after the deferred signals.
+-- @name signal_stats
+-- @class function
+
+--- Get statistics about ignoring enter and leave events while windows are
+-- moved, mapped or unmapped. Nested scopes do not change any event mask and
+-- banned clients are left alone. During a refresh, the first scope lasts until
+-- the end of the refresh and the following ones are nested.
+-- @return A table with the number of outermost scopes in the scopes field, the
+-- number of nested ones in the nested field, the number of requests sent to
+-- change an event mask in the requests field and the number of them saved
+-- because the client was banned in the skipped field.
+-- @name enterleave_stats
+-- @class function
+
+--- Get statistics about restacking. Only the windows which are not in the
+-- right order relatively to the others are restacked, so raising a window
+-- costs one request.
+-- @return A table with the number of refreshes which restacked windows in the
+-- refreshes field, the number of windows in their stacking order in the
+-- windows field and the number of restacking requests sent in the requests
+-- field.
+-- @name stack_stats
+-- @class function
+
+--- Compute the geometries of a tiling layout in C, see awful.layout.kernel.
+-- @param name The layout name: tile, fair, spiral, max or magnifier.
+-- @param clients The clients to arrange.
+-- @param area The area to arrange them in.
+-- @param args A table with the layout parameters: orientation, mwfact, nmaster,
+-- ncol and windowfact for tile, horizontal for fair, spiral for spiral and
+-- mwfact and focus for magnifier.
+-- @return A table with the geometry to give to each client, or nothing if the
+-- layout is unknown.
+-- @name layout_kernel
+-- @class function
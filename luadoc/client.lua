@@ -21,6 +21,9 @@ module("client")
 -- @field minimized Define it the client must be iconify, i.e. only visible in
 -- taskbar.
 -- @field size_hints_honor Honor size hints, i.e. respect size ratio.
+-- @field update_interval Minimum time in seconds between two updates of the
+-- client name and icon, changes in between are delayed and only the latest one
+-- is used. 0 disables the limit, values above an hour are clamped.
 -- @field border_width The client border width.
 -- @field border_color The client border color.
 -- @field urgent The client urgent state.
@@ -52,11 +55,35 @@ module("client")
 -- @name get
 -- @class function
 
+--- Get some properties of all clients at once.
+-- @param screen An optional screen number.
+-- @param names An array of property names.
+-- @return A table with, for each client, a table with the properties keyed by
+-- name and the client in the client field.
+-- @name snapshot
+-- @class function
+
+--- Set the geometry of several clients at once, like calling geometry() on
+-- each of them but ignoring the enter and leave events only once.
+-- @param geometries A table with clients as keys and tables with new
+-- coordinates as values. The clients are resized, and their geometry signals
+-- emitted, in the table traversal order, which is unspecified.
+-- @return The number of clients which were resized.
+-- @name apply_geometries
+-- @class function
+
 --- Check if a client is visible on its screen.
 -- @return A boolean value, true if the client is visible, false otherwise.
 -- @name isvisible
 -- @class function
 
+--- Check if a client is sticky or tagged with one of the selected tags, even
+-- if it is minimized or hidden. This is a bitset test, cheaper than looking
+-- through the client tags.
+-- @return A boolean value, true if the client is on a selected tag.
+-- @name maybevisible
+-- @class function
+
 --- Return client geometry.
 -- @param arg1 A table with new coordinates, or none.
 -- @return A table with client coordinates.
@@ -87,6 +114,11 @@ module("client")
 -- @name tags
 -- @class function
 
+--- Get the clients which are transient for this client.
+-- @return A table with the transient clients, bottom of the stack first.
+-- @name transients
+-- @class function
+
 --- Kill a client.
 -- @name kill
 -- @class function
@@ -126,7 +158,23 @@ module("client")
 -- @name emit_signal
 -- @class function
 
+--- Get some properties at once.
+-- @param names An array of property names.
+-- @param t An optional table to fill instead of creating a new one.
+-- @return A table with the property values keyed by name.
+-- @name get_props
+-- @class function
+
 --- Get the number of instances.
 -- @return The number of client objects alive.
 -- @name instances
 -- @class function
+
+--- Defer the property::* signals of the instances. When enabled, a property
+-- signal is only recorded on the object and emitted once at the next refresh,
+-- however many times the property changed. Signals emitted from Lua with
+-- emit_signal are not deferred.
+-- @param enable Optional boolean to enable or disable the deferred mode.
+-- @return True if the property signals are deferred.
+-- @name defer_property_signals
+-- @class function
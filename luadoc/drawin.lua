@@ -57,7 +57,23 @@ module("drawin")
 -- @name emit_signal
 -- @class function
 
+--- Get some properties at once.
+-- @param names An array of property names.
+-- @param t An optional table to fill instead of creating a new one.
+-- @return A table with the property values keyed by name.
+-- @name get_props
+-- @class function
+
 --- Get the number of instances.
 -- @return The number of drawin objects alive.
 -- @name instances
 -- @class function
+
+--- Defer the property::* signals of the instances. When enabled, a property
+-- signal is only recorded on the object and emitted once at the next refresh,
+-- however many times the property changed. Signals emitted from Lua with
+-- emit_signal are not deferred.
+-- @param enable Optional boolean to enable or disable the deferred mode.
+-- @return True if the property signals are deferred.
+-- @name defer_property_signals
+-- @class function
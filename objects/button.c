@@ -84,7 +84,7 @@ static int
 luaA_button_set_modifiers(lua_State *L, button_t *b)
 {
     b->modifiers = luaA_tomodifiers(L, -1);
-    luaA_object_emit_signal(L, -3, "property::modifiers", 0);
+    luaA_object_emit_signal_id(L, -3, SIGNAL_property_modifiers, 0);
     return 0;
 }
 
@@ -92,7 +92,7 @@ static int
 luaA_button_set_button(lua_State *L, button_t *b)
 {
     b->button = luaL_checknumber(L, -1);
-    luaA_object_emit_signal(L, -3, "property::button", 0);
+    luaA_object_emit_signal_id(L, -3, SIGNAL_property_button, 0);
     return 0;
 }
 
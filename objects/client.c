@@ -19,6 +19,8 @@
  *
  */
 
+#include <math.h>
+
 #include <xcb/xcb_atom.h>
 #include <xcb/xcb_image.h>
 #include <xcb/shape.h>
@@ -32,9 +34,13 @@
 #include "spawn.h"
 #include "luaa.h"
 #include "xwindow.h"
+#include "winindex.h"
 #include "common/atoms.h"
 #include "common/xutil.h"
 
+/** Largest update interval of the name and icon, in seconds */
+#define CLIENT_UPDATE_INTERVAL_MAX 3600
+
 static area_t titlebar_get_area(client_t *c, client_titlebar_t bar);
 static drawable_t *titlebar_get_drawable(lua_State *L, client_t *c, int cl_idx, client_titlebar_t bar);
 
@@ -46,6 +52,8 @@ static void
 client_wipe(client_t *c)
 {
     key_array_wipe(&c->keys);
+    bitset_wipe(&c->tags);
+    client_array_wipe(&c->transients);
     xcb_icccm_get_wm_protocols_reply_wipe(&c->protocols);
     p_delete(&c->machine);
     p_delete(&c->class);
@@ -86,7 +94,7 @@ client_set_urgent(lua_State *L, int cidx, bool urgent)
 
         xcb_icccm_set_wm_hints(globalconf.connection, c->window, &wmh);
 
-        luaA_object_emit_signal(L, cidx, "property::urgent", 0);
+        luaA_object_emit_signal_id(L, cidx, SIGNAL_property_urgent, 0);
     }
 }
 
@@ -98,16 +106,199 @@ client_set_urgent(lua_State *L, int cidx, bool urgent)
         if(c->prop != value) \
         { \
             c->prop = value; \
-            luaA_object_emit_signal(L, cidx, "property::" #prop, 0); \
+            luaA_object_emit_signal_id(L, cidx, SIGNAL_property_##prop, 0); \
         } \
     }
 DO_CLIENT_SET_PROPERTY(group_window)
 DO_CLIENT_SET_PROPERTY(type)
-DO_CLIENT_SET_PROPERTY(transient_for)
 DO_CLIENT_SET_PROPERTY(pid)
 DO_CLIENT_SET_PROPERTY(skip_taskbar)
 #undef DO_CLIENT_SET_PROPERTY
 
+/** Remove a client from the transient windows of another one.
+ * \param parent The client it is transient for.
+ * \param c The transient client.
+ */
+static void
+client_transients_remove(client_t *parent, client_t *c)
+{
+    foreach(tc, parent->transients)
+        if(*tc == c)
+        {
+            client_array_remove(&parent->transients, tc);
+            break;
+        }
+}
+
+/** Keep the transient windows of a client in stacking order when one of them
+ * is put at the top or at the bottom of the stack.
+ * \param c The client which was moved in the stack.
+ * \param top True if it was put on top, false if at the bottom.
+ */
+void
+client_transient_restack(client_t *c, bool top)
+{
+    if(!c->transient_for)
+        return;
+
+    client_transients_remove(c->transient_for, c);
+    if(top)
+        client_array_append(&c->transient_for->transients, c);
+    else
+        client_array_push(&c->transient_for->transients, c);
+}
+
+/** A group of clients sharing a leader window */
+typedef struct
+{
+    /** The clients of the group */
+    client_array_t members;
+    /** Its modal clients which are not transient for a window, and so are
+     * modal for the whole group */
+    client_array_t modals;
+} client_group_t;
+
+/** Groups of clients, indexed by their leader window */
+static GHashTable *client_groups;
+
+/** Look a group up.
+ * \param leader The leader window of the group.
+ * \return The group, or NULL.
+ */
+static client_group_t *
+client_group_get(xcb_window_t leader)
+{
+    if(!client_groups || leader == XCB_NONE)
+        return NULL;
+    return g_hash_table_lookup(client_groups, GUINT_TO_POINTER(leader));
+}
+
+/** Get the clients of a group.
+ * \param leader The leader window of the group.
+ * \return The clients which have this leader window, or NULL.
+ */
+client_array_t *
+client_get_group(xcb_window_t leader)
+{
+    client_group_t *group = client_group_get(leader);
+    return group ? &group->members : NULL;
+}
+
+/** Get the clients modal for a whole group.
+ * \param leader The leader window of the group.
+ * \return The modal clients of the group not transient for a window, or NULL.
+ */
+client_array_t *
+client_get_group_modals(xcb_window_t leader)
+{
+    client_group_t *group = client_group_get(leader);
+    return group && group->modals.len ? &group->modals : NULL;
+}
+
+static void
+client_group_delete(gpointer data)
+{
+    client_group_t *group = data;
+    client_array_wipe(&group->members);
+    client_array_wipe(&group->modals);
+    p_delete(&group);
+}
+
+/** Remove a client from an array of a group, if it is in it.
+ * \param array The array.
+ * \param c The client.
+ */
+static void
+client_group_array_remove(client_array_t *array, client_t *c)
+{
+    foreach(gc, *array)
+        if(*gc == c)
+        {
+            client_array_remove(array, gc);
+            break;
+        }
+}
+
+/** Keep the modal clients of the group of a client up to date, after its
+ * modal, transient_for or leader window changed.
+ * \param c The client.
+ */
+static void
+client_group_update_modal(client_t *c)
+{
+    client_group_t *group = client_group_get(c->leader_window);
+
+    if(!group)
+        return;
+
+    client_group_array_remove(&group->modals, c);
+    if(c->modal && !c->transient_for)
+        client_array_append(&group->modals, c);
+}
+
+/** Set the client a client is transient for.
+ * \param L The Lua VM state.
+ * \param cidx The client index.
+ * \param transient_for The client it is transient for, or NULL.
+ */
+void
+client_set_transient_for(lua_State *L, int cidx, client_t *transient_for)
+{
+    client_t *c = luaA_checkudata(L, cidx, &client_class);
+
+    if(c->transient_for != transient_for)
+    {
+        if(c->transient_for)
+            client_transients_remove(c->transient_for, c);
+        c->transient_for = transient_for;
+        /* Windows which are new or get a parent are usually raised */
+        if(transient_for)
+            client_array_append(&transient_for->transients, c);
+        client_group_update_modal(c);
+        stack_windows();
+        luaA_object_emit_signal_id(L, cidx, SIGNAL_property_transient_for, 0);
+    }
+}
+
+/** Set the leader window of a client, and move it to its new group.
+ * \param c The client.
+ * \param leader The leader window.
+ */
+void
+client_set_leader_window(client_t *c, xcb_window_t leader)
+{
+    client_group_t *group;
+
+    if(c->leader_window == leader)
+        return;
+
+    if((group = client_group_get(c->leader_window)))
+    {
+        client_group_array_remove(&group->members, c);
+        client_group_array_remove(&group->modals, c);
+        if(!group->members.len)
+            g_hash_table_remove(client_groups, GUINT_TO_POINTER(c->leader_window));
+    }
+
+    c->leader_window = leader;
+
+    if(leader != XCB_NONE)
+    {
+        if(!client_groups)
+            client_groups = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                                  NULL, client_group_delete);
+        if(!(group = client_group_get(leader)))
+        {
+            group = p_new(client_group_t, 1);
+            g_hash_table_insert(client_groups, GUINT_TO_POINTER(leader), group);
+        }
+        client_array_append(&group->members, c);
+        client_group_update_modal(c);
+    }
+
+    stack_windows();
+}
+
 #define DO_CLIENT_SET_STRING_PROPERTY2(prop, signal) \
     void \
     client_set_##prop(lua_State *L, int cidx, char *value) \
@@ -115,7 +306,7 @@ DO_CLIENT_SET_PROPERTY(skip_taskbar)
         client_t *c = luaA_checkudata(L, cidx, &client_class); \
         p_delete(&c->prop); \
         c->prop = value; \
-        luaA_object_emit_signal(L, cidx, "property::" #signal, 0); \
+        luaA_object_emit_signal_id(L, cidx, SIGNAL_property_##signal, 0); \
     }
 #define DO_CLIENT_SET_STRING_PROPERTY(prop) \
         DO_CLIENT_SET_STRING_PROPERTY2(prop, prop)
@@ -134,28 +325,20 @@ client_set_class_instance(lua_State *L, int cidx, const char *class, const char
     p_delete(&c->class);
     p_delete(&c->instance);
     c->class = a_strdup(class);
-    luaA_object_emit_signal(L, cidx, "property::class", 0);
+    luaA_object_emit_signal_id(L, cidx, SIGNAL_property_class, 0);
     c->instance = a_strdup(instance);
-    luaA_object_emit_signal(L, cidx, "property::instance", 0);
+    luaA_object_emit_signal_id(L, cidx, SIGNAL_property_instance, 0);
 }
 
-/** Returns true if a client is tagged
- * with one of the tags of the specified screen.
+/** Returns true if a client is sticky or tagged with one of the selected
+ * tags.
  * \param c The client to check.
- * \param screen Virtual screen.
  * \return true if the client is visible, false otherwise.
  */
 bool
 client_maybevisible(client_t *c)
 {
-    if(c->sticky)
-        return true;
-
-    foreach(tag, globalconf.tags)
-        if(tag_get_selected(*tag) && is_client_tagged(c, *tag))
-            return true;
-
-    return false;
+    return c->sticky || bitset_intersects(&c->tags, &globalconf.tags_selected);
 }
 
 /** Get a client by its window.
@@ -165,11 +348,7 @@ client_maybevisible(client_t *c)
 client_t *
 client_getbywin(xcb_window_t w)
 {
-    foreach(c, globalconf.clients)
-        if((*c)->window == w)
-            return *c;
-
-    return NULL;
+    return winindex_get(WININDEX_CLIENT, w);
 }
 
 /** Get a client by its frame window.
@@ -179,11 +358,7 @@ client_getbywin(xcb_window_t w)
 client_t *
 client_getbyframewin(xcb_window_t w)
 {
-    foreach(c, globalconf.clients)
-        if((*c)->frame_window == w)
-            return *c;
-
-    return NULL;
+    return winindex_get(WININDEX_FRAME, w);
 }
 
 /** Unfocus a client (internal).
@@ -195,7 +370,7 @@ client_unfocus_internal(client_t *c)
     globalconf.focus.client = NULL;
 
     luaA_object_push(globalconf.L, c);
-    luaA_object_emit_signal(globalconf.L, -1, "unfocus", 0);
+    luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_unfocus, 0);
     lua_pop(globalconf.L, 1);
 }
 
@@ -249,39 +424,133 @@ client_ban(client_t *c)
     }
 }
 
+/** Nesting depth of client_ignore_enterleave_events() */
+static int client_enterleave_depth;
+/** Nesting depth of client_enterleave_batch_begin() */
+static int client_enterleave_batch;
+/** True if a scope opened during the current batch is held until its end */
+static bool client_enterleave_batch_held;
+
+enterleave_stats_t enterleave_stats;
+
+/** Select or deselect the enter and leave events of a client.
+ * \param c The client.
+ * \param ignore True to stop receiving the events, false to get them back.
+ */
+static void
+client_enterleave_select(client_t *c, bool ignore)
+{
+    uint32_t ignored = ignore ? XCB_EVENT_MASK_ENTER_WINDOW | XCB_EVENT_MASK_LEAVE_WINDOW : 0;
+
+    xcb_change_window_attributes(globalconf.connection,
+                                 c->window,
+                                 XCB_CW_EVENT_MASK,
+                                 (const uint32_t []) { CLIENT_SELECT_INPUT_EVENT_MASK & ~ignored });
+    xcb_change_window_attributes(globalconf.connection,
+                                 c->frame_window,
+                                 XCB_CW_EVENT_MASK,
+                                 (const uint32_t []) { FRAME_SELECT_INPUT_EVENT_MASK & ~ignored });
+    c->enterleave_ignored = ignore;
+    enterleave_stats.requests += 2;
+}
+
 /** This is part of The Bob Marley Algorithm: we ignore enter and leave window
  * in certain cases, like map/unmap or move, so we don't get spurious events.
+ * Calls can be nested, only the outermost one changes the event masks. Banned
+ * clients are unmapped and get no crossing events, so they are left alone
+ * until client_unban() maps them.
  */
 void
 client_ignore_enterleave_events(void)
 {
+    if(client_enterleave_depth++)
+    {
+        enterleave_stats.nested++;
+        return;
+    }
+
+    enterleave_stats.scopes++;
+
     foreach(c, globalconf.clients)
+        if((*c)->isbanned)
+            enterleave_stats.skipped += 2;
+        else
+            client_enterleave_select(*c, true);
+
+    /* Keep the scope open until the end of the batch, so that the next ones
+     * nest into it */
+    if(client_enterleave_batch)
     {
-        xcb_change_window_attributes(globalconf.connection,
-                                     (*c)->window,
-                                     XCB_CW_EVENT_MASK,
-                                     (const uint32_t []) { CLIENT_SELECT_INPUT_EVENT_MASK & ~(XCB_EVENT_MASK_ENTER_WINDOW | XCB_EVENT_MASK_LEAVE_WINDOW) });
-        xcb_change_window_attributes(globalconf.connection,
-                                     (*c)->frame_window,
-                                     XCB_CW_EVENT_MASK,
-                                     (const uint32_t []) { FRAME_SELECT_INPUT_EVENT_MASK & ~(XCB_EVENT_MASK_ENTER_WINDOW | XCB_EVENT_MASK_LEAVE_WINDOW) });
+        client_enterleave_depth++;
+        client_enterleave_batch_held = true;
     }
 }
 
+/** Get the enter and leave events back, once the outermost
+ * client_ignore_enterleave_events() call is matched.
+ */
 void
 client_restore_enterleave_events(void)
 {
-    foreach(c, globalconf.clients)
+    if(client_enterleave_depth == 0)
     {
-        xcb_change_window_attributes(globalconf.connection,
-                                     (*c)->window,
-                                     XCB_CW_EVENT_MASK,
-                                     (const uint32_t []) { CLIENT_SELECT_INPUT_EVENT_MASK });
-        xcb_change_window_attributes(globalconf.connection,
-                                     (*c)->frame_window,
-                                     XCB_CW_EVENT_MASK,
-                                     (const uint32_t []) { FRAME_SELECT_INPUT_EVENT_MASK });
+        warn("enter/leave events restored without being ignored");
+        return;
     }
+
+    if(--client_enterleave_depth)
+        return;
+
+    foreach(c, globalconf.clients)
+        if((*c)->enterleave_ignored)
+            client_enterleave_select(*c, false);
+}
+
+/** Start a batch of changes, like a refresh. The first
+ * client_ignore_enterleave_events() scope opened during the batch lasts until
+ * its end, the following ones are nested and do not send any request. Nothing
+ * is sent for a batch which does not ignore the events.
+ */
+void
+client_enterleave_batch_begin(void)
+{
+    client_enterleave_batch++;
+}
+
+/** End a batch of changes, getting the enter and leave events back if they
+ * were ignored during it.
+ */
+void
+client_enterleave_batch_end(void)
+{
+    if(--client_enterleave_batch || !client_enterleave_batch_held)
+        return;
+
+    client_enterleave_batch_held = false;
+    client_restore_enterleave_events();
+}
+
+/** Get statistics about the enter and leave events ignoring.
+ * \param L The Lua VM state.
+ * \return The number of elements pushed on stack.
+ * \luastack
+ * \lreturn A table with the number of outermost and nested scopes, the number
+ * of requests sent to change event masks and the number of them which were
+ * skipped because the client was banned.
+ */
+int
+luaA_enterleave_stats(lua_State *L)
+{
+    lua_newtable(L);
+    lua_pushnumber(L, enterleave_stats.scopes);
+    lua_setfield(L, -2, "scopes");
+    lua_pushnumber(L, enterleave_stats.nested);
+    lua_setfield(L, -2, "nested");
+    lua_pushnumber(L, enterleave_stats.requests);
+    lua_setfield(L, -2, "requests");
+    lua_pushnumber(L, enterleave_stats.skipped);
+    lua_setfield(L, -2, "skipped");
+    return 1;
 }
 
 /** Record that a client got focus.
@@ -313,7 +582,7 @@ client_focus_update(client_t *c)
     luaA_object_push(globalconf.L, c);
     client_set_urgent(globalconf.L, -1, false);
 
-    luaA_object_emit_signal(globalconf.L, -1, "focus", 0);
+    luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_focus, 0);
     lua_pop(globalconf.L, 1);
 }
 
@@ -370,82 +639,60 @@ client_focus_refresh(void)
                         win, globalconf.timestamp);
 }
 
-static void
-client_update_properties(client_t *c)
-{
-    /* get all hints */
-    xcb_get_property_cookie_t wm_normal_hints   = property_get_wm_normal_hints(c);
-    xcb_get_property_cookie_t wm_hints          = property_get_wm_hints(c);
-    xcb_get_property_cookie_t wm_transient_for  = property_get_wm_transient_for(c);
-    xcb_get_property_cookie_t wm_client_leader  = property_get_wm_client_leader(c);
-    xcb_get_property_cookie_t wm_client_machine = property_get_wm_client_machine(c);
-    xcb_get_property_cookie_t wm_window_role    = property_get_wm_window_role(c);
-    xcb_get_property_cookie_t net_wm_pid        = property_get_net_wm_pid(c);
-    xcb_get_property_cookie_t net_wm_icon       = property_get_net_wm_icon(c);
-    xcb_get_property_cookie_t wm_name           = property_get_wm_name(c);
-    xcb_get_property_cookie_t net_wm_name       = property_get_net_wm_name(c);
-    xcb_get_property_cookie_t wm_icon_name      = property_get_wm_icon_name(c);
-    xcb_get_property_cookie_t net_wm_icon_name  = property_get_net_wm_icon_name(c);
-    xcb_get_property_cookie_t wm_class          = property_get_wm_class(c);
-    xcb_get_property_cookie_t wm_protocols      = property_get_wm_protocols(c);
-    xcb_get_property_cookie_t opacity           = xwindow_get_opacity_unchecked(c->window);
-
-    /* update strut */
-    ewmh_process_client_strut(c);
-
-    /* Now process all replies */
-    property_update_wm_normal_hints(c, wm_normal_hints);
-    property_update_wm_hints(c, wm_hints);
-    property_update_wm_transient_for(c, wm_transient_for);
-    property_update_wm_client_leader(c, wm_client_leader);
-    property_update_wm_client_machine(c, wm_client_machine);
-    property_update_wm_window_role(c, wm_window_role);
-    property_update_net_wm_pid(c, net_wm_pid);
-    property_update_net_wm_icon(c, net_wm_icon);
-    property_update_wm_name(c, wm_name);
-    property_update_net_wm_name(c, net_wm_name);
-    property_update_wm_icon_name(c, wm_icon_name);
-    property_update_net_wm_icon_name(c, net_wm_icon_name);
-    property_update_wm_class(c, wm_class);
-    property_update_wm_protocols(c, wm_protocols);
-    window_set_opacity(globalconf.L, -1, xwindow_get_opacity_from_cookie(opacity));
-}
-
-/** Manage a new client.
- * \param w The window.
- * \param wgeom Window geometry.
- * \param startup True if we are managing at startup time.
+/** Properties fetched when a client is managed */
+static const struct
+{
+    property_get_func_t get;
+    property_update_func_t update;
+} client_properties[] =
+{
+    { property_get_wm_normal_hints, property_update_wm_normal_hints },
+    { property_get_wm_hints, property_update_wm_hints },
+    { property_get_wm_transient_for, property_update_wm_transient_for },
+    { property_get_wm_client_leader, property_update_wm_client_leader },
+    { property_get_wm_client_machine, property_update_wm_client_machine },
+    { property_get_wm_window_role, property_update_wm_window_role },
+    { property_get_net_wm_pid, property_update_net_wm_pid },
+    { property_get_net_wm_icon, property_update_net_wm_icon },
+    { property_get_wm_name, property_update_wm_name },
+    { property_get_net_wm_name, property_update_net_wm_name },
+    { property_get_wm_icon_name, property_update_wm_icon_name },
+    { property_get_net_wm_icon_name, property_update_net_wm_icon_name },
+    { property_get_wm_class, property_update_wm_class },
+    { property_get_wm_protocols, property_update_wm_protocols },
+};
+
+/** A window being managed. The requests for all of its properties are sent
+ * before any reply is waited for, so that managing many windows does not cost
+ * a round trip per window.
  */
-void
-client_manage(xcb_window_t w, xcb_get_geometry_reply_t *wgeom, bool startup)
+typedef struct
+{
+    /** The window */
+    xcb_window_t window;
+    /** The frame window it is reparented into */
+    xcb_window_t frame_window;
+    /** The window geometry */
+    xcb_get_geometry_reply_t *geometry;
+    /** Pending requests */
+    xcb_get_property_cookie_t strut;
+    xcb_get_property_cookie_t opacity;
+    ewmh_client_hints_cookie_t hints;
+    xcb_get_property_cookie_t properties[countof(client_properties)];
+} client_manage_t;
+
+/** Create the frame window of a window being managed and reparent the window
+ * into it.
+ * \param m The window being managed.
+ */
+static void
+client_manage_reparent(client_manage_t *m)
 {
-    const uint32_t select_input_val[] = { CLIENT_SELECT_INPUT_EVENT_MASK };
-
-    if(systray_iskdedockapp(w))
-    {
-        systray_request_handle(w, NULL);
-        return;
-    }
-
-    /* If this is a new client that just has been launched, then request its
-     * startup id. */
-    xcb_get_property_cookie_t startup_id_q = { 0 };
-    if(!startup)
-        startup_id_q = xcb_get_property(globalconf.connection, false, w,
-                                        _NET_STARTUP_ID, XCB_GET_PROPERTY_TYPE_ANY, 0, UINT_MAX);
-
-    /* Make sure the window is automatically mapped if awesome exits or dies. */
-    xcb_change_save_set(globalconf.connection, XCB_SET_MODE_INSERT, w);
-
-    client_t *c = client_new(globalconf.L);
-    xcb_screen_t *s = globalconf.screen;
+    xcb_get_geometry_reply_t *wgeom = m->geometry;
 
-    /* consider the window banned */
-    c->isbanned = true;
-    /* Store window */
-    c->window = w;
-    c->frame_window = xcb_generate_id(globalconf.connection);
-    xcb_create_window(globalconf.connection, globalconf.default_depth, c->frame_window, s->root,
+    m->frame_window = xcb_generate_id(globalconf.connection);
+    xcb_create_window(globalconf.connection, globalconf.default_depth, m->frame_window,
+                      globalconf.screen->root,
                       wgeom->x, wgeom->y, wgeom->width, wgeom->height,
                       wgeom->border_width, XCB_COPY_FROM_PARENT, globalconf.visual->visual_id,
                       XCB_CW_BACK_PIXEL | XCB_CW_BORDER_PIXEL | XCB_CW_BIT_GRAVITY
@@ -462,42 +709,52 @@ client_manage(xcb_window_t w, xcb_get_geometry_reply_t *wgeom, bool startup)
                           globalconf.default_cmap
                       });
 
-    if (startup)
-    {
-        /* The client is already mapped, thus we must be sure that we don't send
-         * ourselves an UnmapNotify due to the xcb_reparent_window().
-         *
-         * Grab the server to make sure we don't lose any events.
-         */
-        uint32_t no_event[] = { 0 };
-        xcb_grab_server(globalconf.connection);
+    xcb_reparent_window(globalconf.connection, m->window, m->frame_window, 0, 0);
+    xcb_map_window(globalconf.connection, m->window);
+}
 
-        xcb_change_window_attributes(globalconf.connection,
-                                     globalconf.screen->root,
-                                     XCB_CW_EVENT_MASK,
-                                     no_event);
-    }
+/** Select the events of a reparented window and send the requests for all the
+ * properties needed to manage it.
+ * \param m The window being managed.
+ */
+static void
+client_manage_request(client_manage_t *m)
+{
+    const uint32_t select_input_val[] = { CLIENT_SELECT_INPUT_EVENT_MASK };
 
-    xcb_reparent_window(globalconf.connection, w, c->frame_window, 0, 0);
-    xcb_map_window(globalconf.connection, w);
+    /* Do this now so that we don't get any events for the reparenting
+     * (Else, reparent could cause an UnmapNotify), but before requesting the
+     * properties so that we don't miss any change. */
+    xcb_change_window_attributes(globalconf.connection, m->window, XCB_CW_EVENT_MASK, select_input_val);
 
-    if (startup)
-    {
-        xcb_change_window_attributes(globalconf.connection,
-                                     globalconf.screen->root,
-                                     XCB_CW_EVENT_MASK,
-                                     ROOT_WINDOW_EVENT_MASK);
-        xcb_ungrab_server(globalconf.connection);
-    }
+    m->strut = ewmh_client_strut_get_unchecked(m->window);
+    for(size_t i = 0; i < countof(client_properties); i++)
+        m->properties[i] = client_properties[i].get(m->window);
+    m->opacity = xwindow_get_opacity_unchecked(m->window);
+    m->hints = ewmh_client_hints_get_unchecked(m->window);
+}
+
+/** Create the client of a window being managed, using the replies to the
+ * requests sent by client_manage_request().
+ * \param m The window being managed.
+ * \return The new client, which is also left on top of the Lua stack.
+ */
+static client_t *
+client_manage_setup(client_manage_t *m)
+{
+    xcb_get_geometry_reply_t *wgeom = m->geometry;
+    client_t *c = client_new(globalconf.L);
 
-    /* Do this now so that we don't get any events for the above
-     * (Else, reparent could cause an UnmapNotify) */
-    xcb_change_window_attributes(globalconf.connection, w, XCB_CW_EVENT_MASK, select_input_val);
+    /* consider the window banned */
+    c->isbanned = true;
+    /* Store window */
+    c->window = m->window;
+    c->frame_window = m->frame_window;
 
-    luaA_object_emit_signal(globalconf.L, -1, "property::window", 0);
+    luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_window, 0);
 
     /* The frame window gets the border, not the real client window */
-    xcb_configure_window(globalconf.connection, w,
+    xcb_configure_window(globalconf.connection, c->window,
                          XCB_CONFIG_WINDOW_BORDER_WIDTH,
                          (uint32_t[]) { 0 });
 
@@ -512,6 +769,8 @@ client_manage(xcb_window_t w, xcb_get_geometry_reply_t *wgeom, bool startup)
     /* Duplicate client and push it in client list */
     lua_pushvalue(globalconf.L, -1);
     client_array_push(&globalconf.clients, luaA_object_ref(globalconf.L, -1));
+    winindex_add(WININDEX_CLIENT, c->window, c);
+    winindex_add(WININDEX_FRAME, c->frame_window, c);
 
     /* Set the right screen */
     screen_client_moveto(c, screen_getbycoord(wgeom->x, wgeom->y), false);
@@ -520,27 +779,32 @@ client_manage(xcb_window_t w, xcb_get_geometry_reply_t *wgeom, bool startup)
      * been set. */
 #define HANDLE_GEOM(attr) \
     c->geometry.attr = wgeom->attr; \
-    luaA_object_emit_signal(globalconf.L, -1, "property::" #attr, 0);
+    luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_##attr, 0);
 HANDLE_GEOM(x)
 HANDLE_GEOM(y)
 HANDLE_GEOM(width)
 HANDLE_GEOM(height)
 #undef HANDLE_GEOM
 
-    luaA_object_emit_signal(globalconf.L, -1, "property::geometry", 0);
+    luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_geometry, 0);
 
     /* Set border width */
     window_set_border_width(globalconf.L, -1, wgeom->border_width);
 
     /* we honor size hints by default */
     c->size_hints_honor = true;
-    luaA_object_emit_signal(globalconf.L, -1, "property::size_hints_honor", 0);
+    luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_size_hints_honor, 0);
+
+    /* update strut */
+    ewmh_client_strut_get_reply(c, m->strut);
 
     /* update all properties */
-    client_update_properties(c);
+    for(size_t i = 0; i < countof(client_properties); i++)
+        client_properties[i].update(c, m->properties[i]);
+    window_set_opacity(globalconf.L, -1, xwindow_get_opacity_from_cookie(m->opacity));
 
     /* Then check clients hints */
-    ewmh_client_check_hints(c);
+    ewmh_client_hints_get_reply(c, m->hints);
 
     /* Push client in stack */
     client_raise(c);
@@ -563,6 +827,66 @@ HANDLE_GEOM(height)
      */
     xwindow_set_state(c->window, XCB_ICCCM_WM_STATE_NORMAL);
 
+    return c;
+}
+
+/** Manage a new client.
+ * \param w The window.
+ * \param wgeom Window geometry.
+ * \param startup True if we are managing at startup time.
+ */
+void
+client_manage(xcb_window_t w, xcb_get_geometry_reply_t *wgeom, bool startup)
+{
+    client_manage_t m = { .window = w, .geometry = wgeom };
+
+    if(systray_iskdedockapp(w))
+    {
+        systray_request_handle(w, NULL);
+        return;
+    }
+
+    /* If this is a new client that just has been launched, then request its
+     * startup id. */
+    xcb_get_property_cookie_t startup_id_q = { 0 };
+    if(!startup)
+        startup_id_q = xcb_get_property(globalconf.connection, false, w,
+                                        _NET_STARTUP_ID, XCB_GET_PROPERTY_TYPE_ANY, 0, UINT_MAX);
+
+    /* Make sure the window is automatically mapped if awesome exits or dies. */
+    xcb_change_save_set(globalconf.connection, XCB_SET_MODE_INSERT, w);
+
+    if (startup)
+    {
+        /* The client is already mapped, thus we must be sure that we don't send
+         * ourselves an UnmapNotify due to the xcb_reparent_window().
+         *
+         * Grab the server to make sure we don't lose any events.
+         */
+        uint32_t no_event[] = { 0 };
+        xcb_grab_server(globalconf.connection);
+
+        xcb_change_window_attributes(globalconf.connection,
+                                     globalconf.screen->root,
+                                     XCB_CW_EVENT_MASK,
+                                     no_event);
+    }
+
+    client_manage_reparent(&m);
+
+    if (startup)
+    {
+        xcb_change_window_attributes(globalconf.connection,
+                                     globalconf.screen->root,
+                                     XCB_CW_EVENT_MASK,
+                                     ROOT_WINDOW_EVENT_MASK);
+        xcb_ungrab_server(globalconf.connection);
+    }
+
+    client_manage_request(&m);
+
+    client_t *c = client_manage_setup(&m);
+
     if(!startup)
     {
         /* Request our response */
@@ -575,16 +899,113 @@ HANDLE_GEOM(height)
         p_delete(&startup_id);
     }
 
-    luaA_class_emit_signal(globalconf.L, &client_class, "list", 0);
+    luaA_class_emit_signal_id(globalconf.L, &client_class, SIGNAL_list, 0);
 
     /* client is still on top of the stack; push startup value,
      * and emit signals with one arg */
     lua_pushboolean(globalconf.L, startup);
-    luaA_object_emit_signal(globalconf.L, -2, "manage", 1);
+    luaA_object_emit_signal_id(globalconf.L, -2, SIGNAL_manage, 1);
     /* pop client */
     lua_pop(globalconf.L, 1);
 }
 
+/** Manage many windows at once at startup time. The requests for all the
+ * windows are sent up front, the server is grabbed once around the
+ * reparenting of all of them, and the manage signals are only emitted once
+ * every client has been set up.
+ * \param wins The windows.
+ * \param wgeoms The windows geometries.
+ * \param len The number of windows.
+ */
+void
+client_manage_bulk(xcb_window_t *wins, xcb_get_geometry_reply_t **wgeoms, int len)
+{
+    client_manage_t *m;
+    client_t **clients;
+    xcb_get_property_cookie_t *kde_check;
+    uint32_t no_event[] = { 0 };
+    int count = 0;
+
+    if(len <= 0)
+        return;
+
+    kde_check = p_new(xcb_get_property_cookie_t, len);
+    for(int i = 0; i < len; i++)
+        kde_check[i] = systray_iskdedockapp_unchecked(wins[i]);
+
+    m = p_new(client_manage_t, len);
+    for(int i = 0; i < len; i++)
+        if(systray_iskdedockapp_reply(kde_check[i]))
+            systray_request_handle(wins[i], NULL);
+        else
+        {
+            m[i].window = wins[i];
+            m[i].geometry = wgeoms[i];
+            /* Make sure the window is automatically mapped if awesome exits or dies. */
+            xcb_change_save_set(globalconf.connection, XCB_SET_MODE_INSERT, wins[i]);
+            count++;
+        }
+
+    p_delete(&kde_check);
+
+    /* Only dock apps, there is no client to manage */
+    if(!count)
+    {
+        p_delete(&m);
+        return;
+    }
+
+    clients = p_new(client_t *, len);
+
+    /* The clients are already mapped, thus we must be sure that we don't send
+     * ourselves an UnmapNotify due to the xcb_reparent_window().
+     *
+     * Grab the server to make sure we don't lose any events.
+     */
+    xcb_grab_server(globalconf.connection);
+
+    xcb_change_window_attributes(globalconf.connection,
+                                 globalconf.screen->root,
+                                 XCB_CW_EVENT_MASK,
+                                 no_event);
+
+    for(int i = 0; i < len; i++)
+        if(m[i].window)
+            client_manage_reparent(&m[i]);
+
+    for(int i = 0; i < len; i++)
+        if(m[i].window)
+            client_manage_request(&m[i]);
+
+    xcb_change_window_attributes(globalconf.connection,
+                                 globalconf.screen->root,
+                                 XCB_CW_EVENT_MASK,
+                                 ROOT_WINDOW_EVENT_MASK);
+    xcb_ungrab_server(globalconf.connection);
+
+    for(int i = 0; i < len; i++)
+        if(m[i].window)
+        {
+            clients[i] = client_manage_setup(&m[i]);
+            lua_pop(globalconf.L, 1);
+        }
+
+    luaA_class_emit_signal_id(globalconf.L, &client_class, SIGNAL_list, 0);
+
+    for(int i = 0; i < len; i++)
+        /* Check that a signal handler did not get rid of the client */
+        if(clients[i] && client_getbywin(m[i].window) == clients[i])
+        {
+            luaA_object_push(globalconf.L, clients[i]);
+            lua_pushboolean(globalconf.L, true);
+            luaA_object_emit_signal_id(globalconf.L, -2, SIGNAL_manage, 1);
+            lua_pop(globalconf.L, 1);
+        }
+
+    p_delete(&clients);
+    p_delete(&m);
+}
+
 static void
 client_remove_titlebar_geometry(client_t *c, area_t *geometry)
 {
@@ -724,12 +1145,19 @@ client_apply_size_hints(client_t *c, area_t geometry)
     return geometry;
 }
 
-static void
-client_resize_do(client_t *c, area_t geometry, bool force_notice, bool honor_hints)
+/** Configure the client windows for a new geometry.
+ * Spurious enter/leave events must be ignored by the caller.
+ * \param c The client.
+ * \param geometry The new geometry, with borders.
+ * \param force_notice Send a configure notify even if the size changed.
+ * \param honor_hints Use size hints.
+ * \return The geometry the client had before.
+ */
+static area_t
+client_resize_configure(client_t *c, area_t geometry, bool force_notice, bool honor_hints)
 {
     bool send_notice = force_notice;
     bool hide_titlebars = c->fullscreen;
-    screen_t *new_screen = screen_getbycoord(geometry.x, geometry.y);
 
     if (honor_hints)
         geometry = client_apply_size_hints(c, geometry);
@@ -742,9 +1170,6 @@ client_resize_do(client_t *c, area_t geometry, bool force_notice, bool honor_hin
     area_t old_geometry = c->geometry;
     c->geometry = geometry;
 
-    /* Ignore all spurious enter/leave notify events */
-    client_ignore_enterleave_events();
-
     /* Configure the client for its new size */
     area_t real_geometry = geometry;
     if (!hide_titlebars)
@@ -771,20 +1196,32 @@ client_resize_do(client_t *c, area_t geometry, bool force_notice, bool honor_hin
         /* We are moving without changing the size, see ICCCM 4.2.3 */
         client_send_configure(c);
 
-    client_restore_enterleave_events();
+    return old_geometry;
+}
+
+/** Let everybody know a client was resized.
+ * \param c The client, already configured for its new geometry.
+ * \param old_geometry The geometry the client had before.
+ * \param new_screen The screen of the geometry that was asked for.
+ */
+static void
+client_resize_notify(client_t *c, area_t old_geometry, screen_t *new_screen)
+{
+    area_t geometry = c->geometry;
+    bool hide_titlebars = c->fullscreen;
 
     screen_client_moveto(c, new_screen, false);
 
     luaA_object_push(globalconf.L, c);
-    luaA_object_emit_signal(globalconf.L, -1, "property::geometry", 0);
+    luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_geometry, 0);
     if (old_geometry.x != geometry.x)
-        luaA_object_emit_signal(globalconf.L, -1, "property::x", 0);
+        luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_x, 0);
     if (old_geometry.y != geometry.y)
-        luaA_object_emit_signal(globalconf.L, -1, "property::y", 0);
+        luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_y, 0);
     if (old_geometry.width != geometry.width)
-        luaA_object_emit_signal(globalconf.L, -1, "property::width", 0);
+        luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_width, 0);
     if (old_geometry.height != geometry.height)
-        luaA_object_emit_signal(globalconf.L, -1, "property::height", 0);
+        luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_height, 0);
     lua_pop(globalconf.L, 1);
 
     /* Update all titlebars */
@@ -832,42 +1269,67 @@ client_resize_do(client_t *c, area_t geometry, bool force_notice, bool honor_hin
     }
 }
 
-/** Resize client window.
- * The sizes given as parameters are with borders!
- * \param c Client to resize.
- * \param geometry New window geometry.
- * \param honor_hints Use size hints.
- * \return true if an actual resize occurred.
+static void
+client_resize_do(client_t *c, area_t geometry, bool force_notice, bool honor_hints)
+{
+    screen_t *new_screen = screen_getbycoord(geometry.x, geometry.y);
+    area_t old_geometry;
+
+    /* Ignore all spurious enter/leave notify events */
+    client_ignore_enterleave_events();
+    old_geometry = client_resize_configure(c, geometry, force_notice, honor_hints);
+    client_restore_enterleave_events();
+
+    client_resize_notify(c, old_geometry, new_screen);
+}
+
+/** Fix a geometry asked for a client before resizing it.
+ * \param c The client.
+ * \param geometry The geometry to fix.
+ * \return false if the client cannot be resized to this geometry.
  */
-bool
-client_resize(client_t *c, area_t geometry, bool honor_hints)
+static bool
+client_resize_check(client_t *c, area_t *geometry)
 {
     area_t area;
 
     /* offscreen appearance fixes */
     area = display_area_get();
 
-    if(geometry.x > area.width)
-        geometry.x = area.width - geometry.width;
-    if(geometry.y > area.height)
-        geometry.y = area.height - geometry.height;
-    if(geometry.x + geometry.width < 0)
-        geometry.x = 0;
-    if(geometry.y + geometry.height < 0)
-        geometry.y = 0;
+    if(geometry->x > area.width)
+        geometry->x = area.width - geometry->width;
+    if(geometry->y > area.height)
+        geometry->y = area.height - geometry->height;
+    if(geometry->x + geometry->width < 0)
+        geometry->x = 0;
+    if(geometry->y + geometry->height < 0)
+        geometry->y = 0;
 
-    if(geometry.width < c->titlebar[CLIENT_TITLEBAR_LEFT].size + c->titlebar[CLIENT_TITLEBAR_RIGHT].size)
+    if(geometry->width < c->titlebar[CLIENT_TITLEBAR_LEFT].size + c->titlebar[CLIENT_TITLEBAR_RIGHT].size)
         return false;
-    if(geometry.height < c->titlebar[CLIENT_TITLEBAR_TOP].size + c->titlebar[CLIENT_TITLEBAR_BOTTOM].size)
+    if(geometry->height < c->titlebar[CLIENT_TITLEBAR_TOP].size + c->titlebar[CLIENT_TITLEBAR_BOTTOM].size)
         return false;
 
-    if(geometry.width == 0 || geometry.height == 0)
+    if(geometry->width == 0 || geometry->height == 0)
         return false;
 
-    if(c->geometry.x != geometry.x
-       || c->geometry.y != geometry.y
-       || c->geometry.width != geometry.width
-       || c->geometry.height != geometry.height)
+    return c->geometry.x != geometry->x
+        || c->geometry.y != geometry->y
+        || c->geometry.width != geometry->width
+        || c->geometry.height != geometry->height;
+}
+
+/** Resize client window.
+ * The sizes given as parameters are with borders!
+ * \param c Client to resize.
+ * \param geometry New window geometry.
+ * \param honor_hints Use size hints.
+ * \return true if an actual resize occurred.
+ */
+bool
+client_resize(client_t *c, area_t geometry, bool honor_hints)
+{
+    if(client_resize_check(c, &geometry))
     {
         client_resize_do(c, geometry, false, honor_hints);
 
@@ -877,6 +1339,69 @@ client_resize(client_t *c, area_t geometry, bool honor_hints)
     return false;
 }
 
+/** Resize several clients at once.
+ * Spurious enter/leave events are ignored once around all the resizes,
+ * instead of once per client like client_resize() does.
+ * The sizes given as parameters are with borders!
+ * \param clients The clients to resize.
+ * \param geometries The new geometries, in the same order as the clients.
+ * The array is used as scratch space and does not hold them afterwards.
+ * \param count The number of clients.
+ * \return The number of clients which were actually resized.
+ */
+int
+client_resize_many(client_t **clients, area_t *geometries, int count)
+{
+    screen_t **screens = p_new(screen_t *, count);
+    int resized = 0;
+
+    client_ignore_enterleave_events();
+
+    for(int i = 0; i < count; i++)
+        if(client_resize_check(clients[i], &geometries[i]))
+        {
+            screens[i] = screen_getbycoord(geometries[i].x, geometries[i].y);
+            geometries[i] = client_resize_configure(clients[i], geometries[i], false,
+                                                    clients[i]->size_hints_honor);
+            resized++;
+        }
+
+    client_restore_enterleave_events();
+
+    /* Lua code may only run once all the windows are where they belong */
+    for(int i = 0; i < count; i++)
+        if(screens[i])
+            client_resize_notify(clients[i], geometries[i], screens[i]);
+
+    p_delete(&screens);
+
+    return resized;
+}
+
+/** Get the geometry a client would end up with when asking for one with
+ * c:geometry(), without resizing it.
+ * \param c The client.
+ * \param geometry The geometry asked for, with borders.
+ * \return The resulting client geometry.
+ */
+area_t
+client_geometry_request(client_t *c, area_t geometry)
+{
+    if(client_isfixed(c))
+    {
+        geometry.width = c->geometry.width;
+        geometry.height = c->geometry.height;
+    }
+
+    if(!client_resize_check(c, &geometry))
+        return c->geometry;
+
+    if(c->size_hints_honor)
+        return client_apply_size_hints(c, geometry);
+
+    return geometry;
+}
+
 /** Set a client minimized, or not.
  * \param L The Lua VM state.
  * \param cidx The client index.
@@ -890,14 +1415,14 @@ client_set_minimized(lua_State *L, int cidx, bool s)
     if(c->minimized != s)
     {
         c->minimized = s;
-        banning_need_update();
+        banning_client_update(c);
         if(s)
             xwindow_set_state(c->window, XCB_ICCCM_WM_STATE_ICONIC);
         else
             xwindow_set_state(c->window, XCB_ICCCM_WM_STATE_NORMAL);
         if(strut_has_value(&c->strut))
-            screen_emit_signal(globalconf.L, c->screen, "property::workarea", 0);
-        luaA_object_emit_signal(L, cidx, "property::minimized", 0);
+            screen_emit_signal_id(globalconf.L, c->screen, SIGNAL_property_workarea, 0);
+        luaA_object_emit_signal_id(L, cidx, SIGNAL_property_minimized, 0);
     }
 }
 
@@ -914,10 +1439,10 @@ client_set_hidden(lua_State *L, int cidx, bool s)
     if(c->hidden != s)
     {
         c->hidden = s;
-        banning_need_update();
+        banning_client_update(c);
         if(strut_has_value(&c->strut))
-            screen_emit_signal(globalconf.L, c->screen, "property::workarea", 0);
-        luaA_object_emit_signal(L, cidx, "property::hidden", 0);
+            screen_emit_signal_id(globalconf.L, c->screen, SIGNAL_property_workarea, 0);
+        luaA_object_emit_signal_id(L, cidx, SIGNAL_property_hidden, 0);
     }
 }
 
@@ -934,8 +1459,8 @@ client_set_sticky(lua_State *L, int cidx, bool s)
     if(c->sticky != s)
     {
         c->sticky = s;
-        banning_need_update();
-        luaA_object_emit_signal(L, cidx, "property::sticky", 0);
+        banning_client_update(c);
+        luaA_object_emit_signal_id(L, cidx, SIGNAL_property_sticky, 0);
     }
 }
 
@@ -965,8 +1490,8 @@ client_set_fullscreen(lua_State *L, int cidx, bool s)
         int abs_cidx = luaA_absindex(L, cidx); \
         lua_pushboolean(L, s);
         c->fullscreen = s;
-        luaA_object_emit_signal(L, abs_cidx, "request::fullscreen", 1);
-        luaA_object_emit_signal(L, abs_cidx, "property::fullscreen", 0);
+        luaA_object_emit_signal_id(L, abs_cidx, SIGNAL_request_fullscreen, 1);
+        luaA_object_emit_signal_id(L, abs_cidx, SIGNAL_property_fullscreen, 0);
         /* Force a client resize, so that titlebars get shown/hidden */
         client_resize_do(c, c->geometry, true, false);
         stack_windows();
@@ -990,8 +1515,8 @@ client_set_fullscreen(lua_State *L, int cidx, bool s)
                 client_set_fullscreen(L, abs_cidx, false); \
             lua_pushboolean(L, s); \
             c->maximized_##type = s; \
-            luaA_object_emit_signal(L, abs_cidx, "request::maximized_" #type, 1); \
-            luaA_object_emit_signal(L, abs_cidx, "property::maximized_" #type, 0); \
+            luaA_object_emit_signal_id(L, abs_cidx, SIGNAL_request_maximized_##type, 1); \
+            luaA_object_emit_signal_id(L, abs_cidx, SIGNAL_property_maximized_##type, 0); \
             stack_windows(); \
         } \
     }
@@ -1020,7 +1545,7 @@ client_set_above(lua_State *L, int cidx, bool s)
         }
         c->above = s;
         stack_windows();
-        luaA_object_emit_signal(L, cidx, "property::above", 0);
+        luaA_object_emit_signal_id(L, cidx, SIGNAL_property_above, 0);
     }
 }
 
@@ -1045,7 +1570,7 @@ client_set_below(lua_State *L, int cidx, bool s)
         }
         c->below = s;
         stack_windows();
-        luaA_object_emit_signal(L, cidx, "property::below", 0);
+        luaA_object_emit_signal_id(L, cidx, SIGNAL_property_below, 0);
     }
 }
 
@@ -1062,8 +1587,9 @@ client_set_modal(lua_State *L, int cidx, bool s)
     if(c->modal != s)
     {
         c->modal = s;
+        client_group_update_modal(c);
         stack_windows();
-        luaA_object_emit_signal(L, cidx, "property::modal", 0);
+        luaA_object_emit_signal_id(L, cidx, SIGNAL_property_modal, 0);
     }
 }
 
@@ -1088,7 +1614,7 @@ client_set_ontop(lua_State *L, int cidx, bool s)
         }
         c->ontop = s;
         stack_windows();
-        luaA_object_emit_signal(L, cidx, "property::ontop", 0);
+        luaA_object_emit_signal_id(L, cidx, SIGNAL_property_ontop, 0);
     }
 }
 
@@ -1100,6 +1626,10 @@ client_unban(client_t *c)
 {
     if(c->isbanned)
     {
+        /* Mapping the client may send it spurious enter/leave events */
+        if(client_enterleave_depth && !c->enterleave_ignored)
+            client_enterleave_select(c, true);
+
         xcb_map_window(globalconf.connection, c->frame_window);
 
         c->isbanned = false;
@@ -1120,12 +1650,12 @@ void
 client_unmanage(client_t *c, bool window_valid)
 {
     /* Reset transient_for attributes of widows that maybe referring to us */
-    foreach(_tc, globalconf.clients)
-    {
-        client_t *tc = *_tc;
-        if(tc->transient_for == c)
-            tc->transient_for = NULL;
-    }
+    foreach(tc, c->transients)
+        (*tc)->transient_for = NULL;
+    client_array_wipe(&c->transients);
+    if(c->transient_for)
+        client_transients_remove(c->transient_for, c);
+    client_set_leader_window(c, XCB_NONE);
 
     if(globalconf.focus.client == c)
         client_unfocus(c);
@@ -1137,18 +1667,27 @@ client_unmanage(client_t *c, bool window_valid)
             client_array_remove(&globalconf.clients, elem);
             break;
         }
+    winindex_remove(WININDEX_CLIENT, c->window);
+    winindex_remove(WININDEX_FRAME, c->frame_window);
+    for(int i = 0; i < CLIENT_LIMITED_COUNT; i++)
+        if(c->limited[i].source_id)
+        {
+            g_source_remove(c->limited[i].source_id);
+            c->limited[i].source_id = 0;
+        }
     stack_client_remove(c);
     for(int i = 0; i < globalconf.tags.len; i++)
         untag_client(c, globalconf.tags.tab[i]);
+    banning_client_remove(c);
 
     luaA_object_push(globalconf.L, c);
-    luaA_object_emit_signal(globalconf.L, -1, "unmanage", 0);
+    luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_unmanage, 0);
     lua_pop(globalconf.L, 1);
 
-    luaA_class_emit_signal(globalconf.L, &client_class, "list", 0);
+    luaA_class_emit_signal_id(globalconf.L, &client_class, SIGNAL_list, 0);
 
     if(strut_has_value(&c->strut))
-        screen_emit_signal(globalconf.L, c->screen, "property::workarea", 0);
+        screen_emit_signal_id(globalconf.L, c->screen, SIGNAL_property_workarea, 0);
 
     /* Get rid of all titlebars */
     for (client_titlebar_t bar = CLIENT_TITLEBAR_TOP; bar < CLIENT_TITLEBAR_COUNT; bar++) {
@@ -1270,6 +1809,41 @@ luaA_client_get(lua_State *L)
     return 1;
 }
 
+/** Get a snapshot of some properties of all clients at once.
+ * \param L The Lua VM state.
+ * \return The number of elements pushed on stack.
+ * \luastack
+ * \lparam An optional screen number.
+ * \lparam An array of property names.
+ * \lreturn A table with, for each client, a table with the properties keyed by
+ * name and the client itself in the client field.
+ */
+static int
+luaA_client_snapshot(lua_State *L)
+{
+    int i = 1, screen;
+
+    screen = luaL_optnumber(L, 1, 0) - 1;
+    luaA_checktable(L, 2);
+
+    if(screen != -1)
+        luaA_checkscreen(screen);
+
+    lua_newtable(L);
+
+    foreach(c, globalconf.clients)
+        if(screen == -1 || (*c)->screen == &globalconf.screens.tab[screen])
+        {
+            lua_createtable(L, 0, luaA_rawlen(L, 2) + 1);
+            luaA_object_push(L, *c);
+            luaA_class_get_props_fill(L, -1, 2, -2);
+            lua_setfield(L, -2, "client");
+            lua_rawseti(L, -2, i++);
+        }
+
+    return 1;
+}
+
 /** Check if a client is visible on its screen.
  * \param L The Lua VM state.
  * \return The number of elements pushed on stack.
@@ -1285,25 +1859,48 @@ luaA_client_isvisible(lua_State *L)
     return 1;
 }
 
-/** Set a client icon.
+/** Check if a client is sticky or tagged with one of the selected tags,
+ * whether it is minimized or hidden or not.
  * \param L The Lua VM state.
- * \param cidx The client index on the stack.
- * \param iidx The image index on the stack.
+ * \return The number of elements pushed on stack.
+ * \luastack
+ * \lvalue A client.
+ * \lreturn A boolean value, true if the client is on a selected tag.
+ */
+static int
+luaA_client_maybevisible(lua_State *L)
+{
+    client_t *c = luaA_checkudata(L, 1, &client_class);
+    lua_pushboolean(L, client_maybevisible(c));
+    return 1;
+}
+
+/** Set a client icon, taking ownership of the surface.
+ * \param c The client.
+ * \param s The image surface, or NULL.
  */
 void
-client_set_icon(client_t *c, cairo_surface_t *s)
+client_take_icon(client_t *c, cairo_surface_t *s)
 {
-    if (s)
-        s = draw_dup_image_surface(s);
     if(c->icon)
         cairo_surface_destroy(c->icon);
     c->icon = s;
 
     luaA_object_push(globalconf.L, c);
-    luaA_object_emit_signal(globalconf.L, -1, "property::icon", 0);
+    luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_icon, 0);
     lua_pop(globalconf.L, 1);
 }
 
+/** Set a client icon.
+ * \param c The client.
+ * \param s The surface to copy, or NULL.
+ */
+void
+client_set_icon(client_t *c, cairo_surface_t *s)
+{
+    client_take_icon(c, s ? draw_dup_image_surface(s) : NULL);
+}
+
 /** Kill a client.
  * \param L The Lua VM state.
  *
@@ -1346,12 +1943,34 @@ luaA_client_swap(lua_State *L)
         *ref_c = swap;
         *ref_swap = c;
 
-        luaA_class_emit_signal(globalconf.L, &client_class, "list", 0);
+        luaA_class_emit_signal_id(globalconf.L, &client_class, SIGNAL_list, 0);
     }
 
     return 0;
 }
 
+/** Get the windows transient for a client.
+ * \param L The Lua VM state.
+ * \return The number of elements pushed on stack.
+ * \luastack
+ * \lvalue A client.
+ * \lreturn A table with the clients transient for this one, bottom first.
+ */
+static int
+luaA_client_transients(lua_State *L)
+{
+    client_t *c = luaA_checkudata(L, 1, &client_class);
+
+    lua_createtable(L, c->transients.len, 0);
+    for(int i = 0; i < c->transients.len; i++)
+    {
+        luaA_object_push(L, c->transients.tab[i]);
+        lua_rawseti(L, -2, i + 1);
+    }
+
+    return 1;
+}
+
 /** Access or set the client tags.
  * \param L The Lua VM state.
  * \return The number of elements pushed on stack.
@@ -1597,6 +2216,34 @@ HANDLE_TITLEBAR(right, CLIENT_TITLEBAR_RIGHT)
 HANDLE_TITLEBAR(bottom, CLIENT_TITLEBAR_BOTTOM)
 HANDLE_TITLEBAR(left, CLIENT_TITLEBAR_LEFT)
 
+/** Get a new client geometry from a table, missing fields and the size of
+ * fixed clients are left as they are.
+ * \param L The Lua VM state.
+ * \param idx The index of the table with the new coordinates.
+ * \param c The client.
+ * \return The new geometry.
+ */
+static area_t
+luaA_client_getopt_geometry(lua_State *L, int idx, client_t *c)
+{
+    area_t geometry;
+
+    geometry.x = luaA_getopt_number(L, idx, "x", c->geometry.x);
+    geometry.y = luaA_getopt_number(L, idx, "y", c->geometry.y);
+    if(client_isfixed(c))
+    {
+        geometry.width = c->geometry.width;
+        geometry.height = c->geometry.height;
+    }
+    else
+    {
+        geometry.width = luaA_getopt_number(L, idx, "width", c->geometry.width);
+        geometry.height = luaA_getopt_number(L, idx, "height", c->geometry.height);
+    }
+
+    return geometry;
+}
+
 /** Return client geometry.
  * \param L The Lua VM state.
  * \return The number of elements pushed on stack.
@@ -1611,28 +2258,58 @@ luaA_client_geometry(lua_State *L)
 
     if(lua_gettop(L) == 2 && !lua_isnil(L, 2))
     {
-        area_t geometry;
-
         luaA_checktable(L, 2);
-        geometry.x = luaA_getopt_number(L, 2, "x", c->geometry.x);
-        geometry.y = luaA_getopt_number(L, 2, "y", c->geometry.y);
-        if(client_isfixed(c))
-        {
-            geometry.width = c->geometry.width;
-            geometry.height = c->geometry.height;
-        }
-        else
-        {
-            geometry.width = luaA_getopt_number(L, 2, "width", c->geometry.width);
-            geometry.height = luaA_getopt_number(L, 2, "height", c->geometry.height);
-        }
-
-        client_resize(c, geometry, c->size_hints_honor);
+        client_resize(c, luaA_client_getopt_geometry(L, 2, c), c->size_hints_honor);
     }
 
     return luaA_pusharea(L, c->geometry);
 }
 
+/** Set the geometry of several clients at once.
+ * \param L The Lua VM state.
+ * \return The number of elements pushed on stack.
+ * \luastack
+ * \lparam A table with clients as keys and tables with new coordinates as
+ * values. The clients are resized in the table traversal order, which is
+ * unspecified.
+ * \lreturn The number of clients which were resized.
+ */
+static int
+luaA_client_apply_geometries(lua_State *L)
+{
+    int count = 0;
+
+    luaA_checktable(L, 1);
+
+    lua_pushnil(L);
+    while(lua_next(L, 1))
+    {
+        luaA_checkudata(L, -2, &client_class);
+        luaA_checktable(L, -1);
+        count++;
+        lua_pop(L, 1);
+    }
+
+    /* The arrays are userdata so that they are collected if a geometry is
+     * wrong */
+    client_t **clients = lua_newuserdata(L, sizeof(client_t *) * count);
+    area_t *geometries = lua_newuserdata(L, sizeof(area_t) * count);
+    int i = 0;
+
+    lua_pushnil(L);
+    while(lua_next(L, 1))
+    {
+        clients[i] = luaA_checkudata(L, -2, &client_class);
+        geometries[i] = luaA_client_getopt_geometry(L, -1, clients[i]);
+        i++;
+        lua_pop(L, 1);
+    }
+
+    lua_pushinteger(L, client_resize_many(clients, geometries, count));
+
+    return 1;
+}
+
 static int
 luaA_client_set_screen(lua_State *L, client_t *c)
 {
@@ -1706,7 +2383,18 @@ static int
 luaA_client_set_size_hints_honor(lua_State *L, client_t *c)
 {
     c->size_hints_honor = luaA_checkboolean(L, -1);
-    luaA_object_emit_signal(L, -3, "property::size_hints_honor", 0);
+    luaA_object_emit_signal_id(L, -3, SIGNAL_property_size_hints_honor, 0);
+    return 0;
+}
+
+static int
+luaA_client_set_update_interval(lua_State *L, client_t *c)
+{
+    double interval = luaL_checknumber(L, -1);
+    if(!isfinite(interval) || interval < 0)
+        luaL_error(L, "invalid update interval");
+    c->update_interval = MIN(interval, CLIENT_UPDATE_INTERVAL_MAX);
+    luaA_object_emit_signal_id(L, -3, SIGNAL_property_update_interval, 0);
     return 0;
 }
 
@@ -1780,6 +2468,7 @@ LUA_OBJECT_EXPORT_PROPERTY(client, client_t, sticky, lua_pushboolean)
 LUA_OBJECT_EXPORT_PROPERTY(client, client_t, size_hints_honor, lua_pushboolean)
 LUA_OBJECT_EXPORT_PROPERTY(client, client_t, maximized_horizontal, lua_pushboolean)
 LUA_OBJECT_EXPORT_PROPERTY(client, client_t, maximized_vertical, lua_pushboolean)
+LUA_OBJECT_EXPORT_PROPERTY(client, client_t, update_interval, lua_pushnumber)
 
 static int
 luaA_client_get_content(lua_State *L, client_t *c)
@@ -2028,7 +2717,7 @@ luaA_client_keys(lua_State *L)
     if(lua_gettop(L) == 2)
     {
         luaA_key_array_set(L, 1, 2, keys);
-        luaA_object_emit_signal(L, 1, "property::keys", 0);
+        luaA_object_emit_signal_id(L, 1, SIGNAL_property_keys, 0);
         xcb_ungrab_key(globalconf.connection, XCB_GRAB_ANY, c->frame_window, XCB_BUTTON_MASK_ANY);
         xwindow_grabkeys(c->frame_window, keys);
     }
@@ -2082,6 +2771,8 @@ client_class_setup(lua_State *L)
     {
         LUA_CLASS_METHODS(client)
         { "get", luaA_client_get },
+        { "snapshot", luaA_client_snapshot },
+        { "apply_geometries", luaA_client_apply_geometries },
         { "__index", luaA_client_module_index },
         { "__newindex", luaA_client_module_newindex },
         { NULL, NULL }
@@ -2093,8 +2784,10 @@ client_class_setup(lua_State *L)
         LUA_CLASS_META
         { "keys", luaA_client_keys },
         { "isvisible", luaA_client_isvisible },
+        { "maybevisible", luaA_client_maybevisible },
         { "geometry", luaA_client_geometry },
         { "tags", luaA_client_tags },
+        { "transients", luaA_client_transients },
         { "kill", luaA_client_kill },
         { "swap", luaA_client_swap },
         { "raise", luaA_client_raise },
@@ -2217,6 +2910,10 @@ client_class_setup(lua_State *L)
                             (lua_class_propfunc_t) luaA_client_set_size_hints_honor,
                             (lua_class_propfunc_t) luaA_client_get_size_hints_honor,
                             (lua_class_propfunc_t) luaA_client_set_size_hints_honor);
+    luaA_class_add_property(&client_class, "update_interval",
+                            (lua_class_propfunc_t) luaA_client_set_update_interval,
+                            (lua_class_propfunc_t) luaA_client_get_update_interval,
+                            (lua_class_propfunc_t) luaA_client_set_update_interval);
     luaA_class_add_property(&client_class, "urgent",
                             (lua_class_propfunc_t) luaA_client_set_urgent,
                             (lua_class_propfunc_t) luaA_client_get_urgent,
@@ -2269,6 +2966,7 @@ client_class_setup(lua_State *L)
     signal_add(&client_class.signals, "property::role");
     signal_add(&client_class.signals, "property::screen");
     signal_add(&client_class.signals, "property::size_hints_honor");
+    signal_add(&client_class.signals, "property::update_interval");
     signal_add(&client_class.signals, "property::skip_taskbar");
     signal_add(&client_class.signals, "property::sticky");
     signal_add(&client_class.signals, "property::struts");
@@ -52,6 +52,15 @@ typedef enum {
     CLIENT_TITLEBAR_COUNT = 4
 } client_titlebar_t;
 
+/** Client properties which updates can be rate limited */
+typedef enum {
+    CLIENT_LIMITED_NAME = 0,
+    CLIENT_LIMITED_ALT_NAME = 1,
+    CLIENT_LIMITED_ICON = 2,
+    /* This is not a valid value, but the number of valid values */
+    CLIENT_LIMITED_COUNT = 3
+} client_limited_t;
+
 /** client_t type */
 struct client_t
 {
@@ -90,6 +99,14 @@ struct client_t
      * Note that the geometry remains unchanged and that the window is still mapped.
      */
     bool isbanned;
+    /** True if the enter and leave events of the client are being ignored */
+    bool enterleave_ignored;
+    /** Tags of the client, indexed by tag slot */
+    bitset_t tags;
+    /** Cached client_isvisible() value, see banning_client_update() */
+    bool visible;
+    /** True if the client is waiting in the banning queue */
+    bool need_banning;
     /** true if the client must be skipped from task bar client list */
     bool skip_taskbar;
     /** True if the client cannot have focus */
@@ -104,6 +121,8 @@ struct client_t
     key_array_t keys;
     /** Icon */
     cairo_surface_t *icon;
+    /** Serial of the last _NET_WM_ICON update, see property.c */
+    unsigned int icon_serial;
     /** Size hints */
     xcb_size_hints_t size_hints;
     bool size_hints_honor;
@@ -115,6 +134,17 @@ struct client_t
     uint32_t pid;
     /** Window it is transient for */
     client_t *transient_for;
+    /** Windows transient for it, bottom first */
+    client_array_t transients;
+    /** Minimum time between two updates of the name and icon, in seconds */
+    double update_interval;
+    /** Rate limiting state of the name and icon updates */
+    struct {
+        /** Time of the last update, in microseconds */
+        gint64 last;
+        /** The pending delayed update, if any */
+        guint source_id;
+    } limited[CLIENT_LIMITED_COUNT];
     /** Titelbar information */
     struct {
         /** The size of this bar. */
@@ -133,6 +163,21 @@ lua_class_t client_class;
 
 LUA_OBJECT_FUNCS(client_class, client_t, client)
 
+/** Statistics about ignoring enter and leave events */
+typedef struct
+{
+    /** Number of outermost client_ignore_enterleave_events() calls */
+    unsigned long scopes;
+    /** Number of nested calls, which did not change any event mask */
+    unsigned long nested;
+    /** Number of requests sent to change an event mask */
+    unsigned long requests;
+    /** Number of requests not sent because the client was banned */
+    unsigned long skipped;
+} enterleave_stats_t;
+
+extern enterleave_stats_t enterleave_stats;
+
 bool client_maybevisible(client_t *);
 client_t * client_getbywin(xcb_window_t);
 client_t * client_getbyframewin(xcb_window_t);
@@ -141,7 +186,10 @@ void client_ban(client_t *);
 void client_ban_unfocus(client_t *);
 void client_unban(client_t *);
 void client_manage(xcb_window_t, xcb_get_geometry_reply_t *, bool);
+void client_manage_bulk(xcb_window_t *, xcb_get_geometry_reply_t **, int);
 bool client_resize(client_t *, area_t, bool);
+int client_resize_many(client_t **, area_t *, int);
+area_t client_geometry_request(client_t *, area_t);
 void client_unmanage(client_t *, bool);
 void client_kill(client_t *);
 void client_set_sticky(lua_State *, int, bool);
@@ -165,7 +213,12 @@ void client_set_transient_for(lua_State *L, int, client_t *);
 void client_set_name(lua_State *L, int, char *);
 void client_set_alt_name(lua_State *L, int, char *);
 void client_set_group_window(lua_State *, int, xcb_window_t);
+void client_set_leader_window(client_t *, xcb_window_t);
+client_array_t *client_get_group(xcb_window_t);
+client_array_t *client_get_group_modals(xcb_window_t);
+void client_transient_restack(client_t *, bool);
 void client_set_icon(client_t *c, cairo_surface_t *s);
+void client_take_icon(client_t *, cairo_surface_t *);
 void client_set_skip_taskbar(lua_State *, int, bool);
 void client_focus(client_t *);
 void client_focus_update(client_t *);
@@ -173,6 +226,9 @@ void client_focus_refresh(void);
 bool client_hasproto(client_t *, xcb_atom_t);
 void client_ignore_enterleave_events(void);
 void client_restore_enterleave_events(void);
+void client_enterleave_batch_begin(void);
+void client_enterleave_batch_end(void);
+int luaA_enterleave_stats(lua_State *);
 void client_refresh(client_t *);
 void client_class_setup(lua_State *);
 void client_send_configure(client_t *);
@@ -225,14 +281,14 @@ client_isfixed(client_t *c)
 
 /** Returns true if a client is tagged with one of the tags of the 
  * specified screen and is not hidden. Note that "banned" clients are included.
+ * The value is cached and kept up to date by banning_client_update().
  * \param c The client to check.
- * \param screen Virtual screen number.
  * \return true if the client is visible, false otherwise.
  */
 static inline bool
 client_isvisible(client_t *c)
 {
-    return (!c->hidden && !c->minimized && client_maybevisible(c));
+    return c->visible;
 }
 
 #endif
@@ -68,7 +68,7 @@ drawable_set_surface(drawable_t *d, int didx, cairo_surface_t *surface, area_t g
     cairo_paint(cr);
     cairo_destroy(cr);
     drawable_set_geometry(d, didx, geom);
-    luaA_object_emit_signal(globalconf.L, didx, "property::surface", 0);
+    luaA_object_emit_signal_id(globalconf.L, didx, SIGNAL_property_surface, 0);
 }
 
 void
@@ -78,13 +78,13 @@ drawable_set_geometry(drawable_t *d, int didx, area_t geom)
     d->geometry = geom;
 
     if (old.x != geom.x)
-        luaA_object_emit_signal(globalconf.L, didx, "property::x", 0);
+        luaA_object_emit_signal_id(globalconf.L, didx, SIGNAL_property_x, 0);
     if (old.y != geom.y)
-        luaA_object_emit_signal(globalconf.L, didx, "property::y", 0);
+        luaA_object_emit_signal_id(globalconf.L, didx, SIGNAL_property_y, 0);
     if (old.width != geom.width)
-        luaA_object_emit_signal(globalconf.L, didx, "property::width", 0);
+        luaA_object_emit_signal_id(globalconf.L, didx, SIGNAL_property_width, 0);
     if (old.height != geom.height)
-        luaA_object_emit_signal(globalconf.L, didx, "property::height", 0);
+        luaA_object_emit_signal_id(globalconf.L, didx, SIGNAL_property_height, 0);
 }
 
 /** Get a drawable's surface
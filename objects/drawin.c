@@ -28,6 +28,7 @@
 #include "luaa.h"
 #include "ewmh.h"
 #include "systray.h"
+#include "winindex.h"
 #include "common/xcursor.h"
 #include "common/xutil.h"
 
@@ -70,6 +71,7 @@ drawin_wipe(drawin_t *w)
         /* Make sure we don't accidentally kill the systray window */
         drawin_systray_kickout(w);
         xcb_destroy_window(globalconf.connection, w->window);
+        winindex_remove(WININDEX_DRAWIN, w->window);
         /* Deactivate BMA */
         client_restore_enterleave_events();
         w->window = XCB_NONE;
@@ -214,13 +216,13 @@ drawin_moveresize(lua_State *L, int udx, area_t geometry)
     client_restore_enterleave_events();
 
     if(mask_vals & XCB_CONFIG_WINDOW_X)
-        luaA_object_emit_signal(L, udx, "property::x", 0);
+        luaA_object_emit_signal_id(L, udx, SIGNAL_property_x, 0);
     if(mask_vals & XCB_CONFIG_WINDOW_Y)
-        luaA_object_emit_signal(L, udx, "property::y", 0);
+        luaA_object_emit_signal_id(L, udx, SIGNAL_property_y, 0);
     if(mask_vals & XCB_CONFIG_WINDOW_WIDTH)
-        luaA_object_emit_signal(L, udx, "property::width", 0);
+        luaA_object_emit_signal_id(L, udx, SIGNAL_property_width, 0);
     if(mask_vals & XCB_CONFIG_WINDOW_HEIGHT)
-        luaA_object_emit_signal(L, udx, "property::height", 0);
+        luaA_object_emit_signal_id(L, udx, SIGNAL_property_height, 0);
 }
 
 /** Refresh the window content by copying its pixmap data to its window.
@@ -259,12 +261,14 @@ drawin_map(drawin_t *drawin, int widx)
     stack_windows();
     /* Add it to the list of visible drawins */
     drawin_array_append(&globalconf.drawins, drawin);
+    winindex_add(WININDEX_DRAWIN, drawin->window, drawin);
 }
 
 static void
 drawin_unmap(drawin_t *drawin)
 {
     xcb_unmap_window(globalconf.connection, drawin->window);
+    winindex_remove(WININDEX_DRAWIN, drawin->window);
     foreach(item, globalconf.drawins)
         if(*item == drawin)
         {
@@ -273,17 +277,14 @@ drawin_unmap(drawin_t *drawin)
         }
 }
 
-/** Get a drawin by its window.
+/** Get a visible drawin by its window.
  * \param win The window id.
  * \return A drawin if found, NULL otherwise.
  */
 drawin_t *
 drawin_getbywin(xcb_window_t win)
 {
-    foreach(w, globalconf.drawins)
-        if((*w)->window == win)
-            return *w;
-    return NULL;
+    return winindex_get(WININDEX_DRAWIN, win);
 }
 
 /** Set a drawin visible or not.
@@ -319,12 +320,12 @@ drawin_set_visible(lua_State *L, int udx, bool v)
             luaA_object_unref(globalconf.L, drawin);
         }
 
-        luaA_object_emit_signal(L, udx, "property::visible", 0);
+        luaA_object_emit_signal_id(L, udx, SIGNAL_property_visible, 0);
         if(strut_has_value(&drawin->strut))
         {
             screen_t *screen =
                 screen_getbycoord(drawin->geometry.x, drawin->geometry.y);
-            screen_emit_signal(globalconf.L, screen, "property::workarea", 0);
+            screen_emit_signal_id(globalconf.L, screen, SIGNAL_property_workarea, 0);
         }
     }
 }
@@ -483,7 +484,7 @@ luaA_drawin_set_ontop(lua_State *L, drawin_t *drawin)
     {
         drawin->ontop = b;
         stack_windows();
-        luaA_object_emit_signal(L, -3, "property::ontop", 0);
+        luaA_object_emit_signal_id(L, -3, SIGNAL_property_ontop, 0);
     }
     return 0;
 }
@@ -506,7 +507,7 @@ luaA_drawin_set_cursor(lua_State *L, drawin_t *drawin)
             p_delete(&drawin->cursor);
             drawin->cursor = a_strdup(buf);
             xwindow_set_cursor(drawin->window, cursor);
-            luaA_object_emit_signal(L, -3, "property::cursor", 0);
+            luaA_object_emit_signal_id(L, -3, SIGNAL_property_cursor, 0);
         }
     }
     return 0;
@@ -52,7 +52,7 @@ luaA_keystore(lua_State *L, int ud, const char *str, ssize_t len)
             key->keycode = atoi(str + 1);
             key->keysym = 0;
         }
-        luaA_object_emit_signal(L, ud, "property::key", 0);
+        luaA_object_emit_signal_id(L, ud, SIGNAL_property_key, 0);
     }
 }
 
@@ -158,7 +158,7 @@ static int
 luaA_key_set_modifiers(lua_State *L, keyb_t *k)
 {
     k->modifiers = luaA_tomodifiers(L, -1);
-    luaA_object_emit_signal(L, -3, "property::modifiers", 0);
+    luaA_object_emit_signal_id(L, -3, SIGNAL_property_modifiers, 0);
     return 0;
 }
 
@@ -36,6 +36,8 @@ struct tag
     bool selected;
     /** clients in this tag */
     client_array_t clients;
+    /** Index of the tag in the tags bitset of the clients */
+    int slot;
 };
 
 static lua_class_t tag_class;
@@ -48,16 +50,62 @@ tag_unref_simplified(tag_t **tag)
     luaA_object_unref(globalconf.L, *tag);
 }
 
+/** Slots used by the existing tags */
+static bitset_t tag_slots;
+
+static tag_t *
+tag_allocator(lua_State *L)
+{
+    tag_t *tag = tag_new(L);
+
+    tag->slot = bitset_first_unset(&tag_slots);
+    bitset_set(&tag_slots, tag->slot);
+
+    return tag;
+}
+
 static void
 tag_wipe(tag_t *tag)
 {
     client_array_wipe(&tag->clients);
     p_delete(&tag->name);
+    bitset_unset(&globalconf.tags_selected, tag->slot);
+    bitset_unset(&tag_slots, tag->slot);
 }
 
 OBJECT_EXPORT_PROPERTY(tag, tag_t, selected)
 OBJECT_EXPORT_PROPERTY(tag, tag_t, name)
 
+/** Recompute the visibility of all the clients of a tag.
+ * \param tag The tag.
+ */
+static void
+tag_update_banning(tag_t *tag)
+{
+    client_t *unfocus = NULL;
+
+    foreach(c, tag->clients)
+        if(banning_client_check(*c) && globalconf.focus.client == *c)
+            unfocus = *c;
+
+    /* Unfocusing runs Lua code which may change the clients of the tag, so it
+     * waits until they were all walked */
+    if(unfocus)
+        client_ban_unfocus(unfocus);
+}
+
+/** Keep the selected tags mask in sync with a tag.
+ * \param tag The tag.
+ */
+static void
+tag_update_selected_mask(tag_t *tag)
+{
+    if(tag->selected && tag->activated)
+        bitset_set(&globalconf.tags_selected, tag->slot);
+    else
+        bitset_unset(&globalconf.tags_selected, tag->slot);
+}
+
 /** View or unview a tag.
  * \param L The Lua VM state.
  * \param udx The index of the tag on the stack.
@@ -70,25 +118,26 @@ tag_view(lua_State *L, int udx, bool view)
     if(tag->selected != view)
     {
         tag->selected = view;
-        banning_need_update();
+        tag_update_selected_mask(tag);
+        tag_update_banning(tag);
         ewmh_update_net_current_desktop();
 
-        luaA_object_emit_signal(L, udx, "property::selected", 0);
+        luaA_object_emit_signal_id(L, udx, SIGNAL_property_selected, 0);
     }
 }
 
 static void
-tag_client_emit_signal(lua_State *L, tag_t *t, client_t *c, const char *signame)
+tag_client_emit_signal(lua_State *L, tag_t *t, client_t *c, unsigned long signal)
 {
     luaA_object_push(L, c);
     luaA_object_push(L, t);
     /* emit signal on client, with new tag as argument */
-    luaA_object_emit_signal(L, -2, signame, 1);
+    luaA_object_emit_signal_id(L, -2, signal, 1);
     /* re push tag */
     luaA_object_push(L, t);
     /* move tag before client */
     lua_insert(L, -2);
-    luaA_object_emit_signal(L, -2, signame, 1);
+    luaA_object_emit_signal_id(L, -2, signal, 1);
     /* Remove tag */
     lua_pop(L, 1);
 }
@@ -108,11 +157,12 @@ tag_client(client_t *c)
         return;
     }
 
+    bitset_set(&c->tags, t->slot);
     client_array_append(&t->clients, c);
     ewmh_client_update_desktop(c);
-    banning_need_update();
+    banning_client_update(c);
 
-    tag_client_emit_signal(globalconf.L, t, c, "tagged");
+    tag_client_emit_signal(globalconf.L, t, c, SIGNAL_tagged);
 }
 
 /** Untag a client with specified tag.
@@ -122,13 +172,18 @@ tag_client(client_t *c)
 void
 untag_client(client_t *c, tag_t *t)
 {
+    if(!is_client_tagged(c, t))
+        return;
+
+    bitset_unset(&c->tags, t->slot);
+
     for(int i = 0; i < t->clients.len; i++)
         if(t->clients.tab[i] == c)
         {
             client_array_take(&t->clients, i);
-            banning_need_update();
+            banning_client_update(c);
             ewmh_client_update_desktop(c);
-            tag_client_emit_signal(globalconf.L, t, c, "untagged");
+            tag_client_emit_signal(globalconf.L, t, c, SIGNAL_untagged);
             luaA_object_unref(globalconf.L, t);
             return;
         }
@@ -142,11 +197,7 @@ untag_client(client_t *c, tag_t *t)
 bool
 is_client_tagged(client_t *c, tag_t *t)
 {
-    for(int i = 0; i < t->clients.len; i++)
-        if(t->clients.tab[i] == c)
-            return true;
-
-    return false;
+    return bitset_test(&c->tags, t->slot);
 }
 
 /** Get the index of the first selected tag.
@@ -265,7 +316,7 @@ luaA_tag_set_name(lua_State *L, tag_t *tag)
     const char *buf = luaL_checklstring(L, -1, &len);
     p_delete(&tag->name);
     a_iso2utf8(buf, len, &tag->name, NULL);
-    luaA_object_emit_signal(L, -3, "property::name", 0);
+    luaA_object_emit_signal_id(L, -3, SIGNAL_property_name, 0);
     ewmh_update_net_desktop_names();
     return 0;
 }
@@ -295,10 +346,13 @@ luaA_tag_set_activated(lua_State *L, tag_t *tag)
         return 0;
 
     tag->activated = activated;
+    tag_update_selected_mask(tag);
     if(activated)
     {
         lua_pushvalue(L, -3);
         tag_array_append(&globalconf.tags, luaA_object_ref_class(L, -1, &tag_class));
+        if(tag->selected)
+            tag_update_banning(tag);
     }
     else
     {
@@ -312,15 +366,16 @@ luaA_tag_set_activated(lua_State *L, tag_t *tag)
         if (tag->selected)
         {
             tag->selected = false;
-            luaA_object_emit_signal(L, -3, "property::selected", 0);
-            banning_need_update();
+            tag_update_selected_mask(tag);
+            luaA_object_emit_signal_id(L, -3, SIGNAL_property_selected, 0);
+            tag_update_banning(tag);
         }
         luaA_object_unref(L, tag);
     }
     ewmh_update_net_numbers_of_desktop();
     ewmh_update_net_desktop_names();
 
-    luaA_object_emit_signal(L, -3, "property::activated", 0);
+    luaA_object_emit_signal_id(L, -3, SIGNAL_property_activated, 0);
 
     return 0;
 }
@@ -344,7 +399,7 @@ tag_class_setup(lua_State *L)
     };
 
     luaA_class_setup(L, &tag_class, "tag", NULL,
-                     (lua_class_allocator_t) tag_new,
+                     (lua_class_allocator_t) tag_allocator,
                      (lua_class_collector_t) tag_wipe,
                      NULL,
                      luaA_class_index_miss_property, luaA_class_newindex_miss_property,
@@ -39,7 +39,7 @@ static gboolean
 timer_emit_signal(gpointer data)
 {
     luaA_object_push(globalconf.L, data);
-    luaA_object_emit_signal(globalconf.L, -1, "timeout", 0);
+    luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_timeout, 0);
     lua_pop(globalconf.L, 1);
     return TRUE;
 }
@@ -56,7 +56,7 @@ luaA_timer_set_timeout(lua_State *L, atimer_t *timer)
 {
     double timeout = luaL_checknumber(L, -1);
     timer->timeout = timeout;
-    luaA_object_emit_signal(L, -3, "property::timeout", 0);
+    luaA_object_emit_signal_id(L, -3, SIGNAL_property_timeout, 0);
     return 0;
 }
 
@@ -55,7 +55,7 @@ luaA_window_buttons(lua_State *L)
     if(lua_gettop(L) == 2)
     {
         luaA_button_array_set(L, 1, 2, &window->buttons);
-        luaA_object_emit_signal(L, 1, "property::buttons", 0);
+        luaA_object_emit_signal_id(L, 1, SIGNAL_property_buttons, 0);
         xwindow_buttons_grab(window_get(window), &window->buttons);
     }
 
@@ -75,11 +75,11 @@ luaA_window_struts(lua_State *L)
     {
         luaA_tostrut(L, 2, &window->strut);
         ewmh_update_strut(window->window, &window->strut);
-        luaA_object_emit_signal(L, 1, "property::struts", 0);
+        luaA_object_emit_signal_id(L, 1, SIGNAL_property_struts, 0);
         /* FIXME: Only emit if the workarea actually changed
          * (= window is visible, only on the right screen)? */
         foreach(s, globalconf.screens)
-            screen_emit_signal(L, s, "property::workarea", 0);
+            screen_emit_signal_id(L, s, SIGNAL_property_workarea, 0);
     }
 
     return luaA_pushstrut(L, window->strut);
@@ -99,7 +99,7 @@ window_set_opacity(lua_State *L, int idx, double opacity)
     {
         window->opacity = opacity;
         xwindow_set_opacity(window_get(window), opacity);
-        luaA_object_emit_signal(L, idx, "property::opacity", 0);
+        luaA_object_emit_signal_id(L, idx, SIGNAL_property_opacity, 0);
     }
 }
 
@@ -153,7 +153,7 @@ luaA_window_set_border_color(lua_State *L, window_t *window)
        color_init_reply(color_init_unchecked(&window->border_color, color_name, len)))
     {
         xwindow_set_border_color(window_get(window), &window->border_color);
-        luaA_object_emit_signal(L, -3, "property::border_color", 0);
+        luaA_object_emit_signal_id(L, -3, SIGNAL_property_border_color, 0);
     }
 
     return 0;
@@ -179,7 +179,7 @@ window_set_border_width(lua_State *L, int idx, int width)
 
     window->border_width = width;
 
-    luaA_object_emit_signal(L, idx, "property::border_width", 0);
+    luaA_object_emit_signal_id(L, idx, SIGNAL_property_border_width, 0);
 }
 
 /** Get the window type.
@@ -290,7 +290,7 @@ luaA_window_set_type(lua_State *L, window_t *w)
         w->type = type;
         if(w->window != XCB_WINDOW_NONE)
             ewmh_update_window_type(w->window, window_translate_type(w->type));
-        luaA_object_emit_signal(globalconf.L, -3, "property::type", 0);
+        luaA_object_emit_signal_id(globalconf.L, -3, SIGNAL_property_type, 0);
     }
 
     return 0;
@@ -27,17 +27,245 @@
 #include "ewmh.h"
 #include "objects/drawin.h"
 #include "xwindow.h"
+#include "winindex.h"
 #include "luaa.h"
 #include "common/atoms.h"
 #include "common/xutil.h"
+#include "event.h"
+
+/** A property request which reply has not been handled yet. */
+typedef struct
+{
+    /** The client the request is for */
+    client_t *client;
+    /** The client window at the time of the request */
+    xcb_window_t window;
+    /** The property atom, for the statistics, or XCB_NONE */
+    xcb_atom_t atom;
+    /** The function handling the reply */
+    property_update_func_t update;
+    /** The request cookie */
+    xcb_get_property_cookie_t cookie;
+} property_request_t;
+
+DO_ARRAY(property_request_t, property_request, DO_NOTHING)
+
+/** Requests sent during event dispatch, handled in property_refresh() */
+static property_request_array_t property_requests;
+
+/** Size of the _NET_WM_ICON replies decoded by a worker thread, in bytes */
+#define PROPERTY_ICON_ASYNC_SIZE (64 * 1024)
+/** Number of worker threads decoding icons */
+#define PROPERTY_ICON_THREADS 2
+
+/** An icon being decoded by a worker thread. */
+typedef struct
+{
+    /** The client the icon is for */
+    client_t *client;
+    /** The client window at the time of the request */
+    xcb_window_t window;
+    /** The client icon_serial at the time of the request */
+    unsigned int serial;
+    /** The reply to decode, freed by the worker */
+    xcb_get_property_reply_t *reply;
+    /** The decoded icon, set by the worker */
+    cairo_surface_t *surface;
+} property_icon_job_t;
+
+/** Worker threads decoding icons, created on first use */
+static GThreadPool *property_icon_pool;
+
+/** A delayed update of a rate limited property. */
+typedef struct
+{
+    /** The client the update is for */
+    client_t *client;
+    /** The client window at the time the update was delayed */
+    xcb_window_t window;
+    /** The delayed property */
+    client_limited_t property;
+} property_delayed_t;
+
+/** Properties which updates are rate limited, see client_t update_interval */
+static const struct
+{
+    property_get_func_t get;
+    property_update_func_t update;
+} property_limited[CLIENT_LIMITED_COUNT] =
+{
+    [CLIENT_LIMITED_NAME] = { property_get_net_wm_name, property_update_net_wm_name },
+    [CLIENT_LIMITED_ALT_NAME] = { property_get_wm_name, property_update_wm_name },
+    [CLIENT_LIMITED_ICON] = { property_get_net_wm_icon, property_update_net_wm_icon },
+};
+
+/** Get the atom of a rate limited property.
+ * \param property The property.
+ * \return The property atom.
+ */
+static xcb_atom_t
+property_limited_atom(client_limited_t property)
+{
+    switch(property)
+    {
+      case CLIENT_LIMITED_NAME:
+        return _NET_WM_NAME;
+      case CLIENT_LIMITED_ALT_NAME:
+        return XCB_ATOM_WM_NAME;
+      case CLIENT_LIMITED_ICON:
+        return _NET_WM_ICON;
+      default:
+        return XCB_NONE;
+    }
+}
+
+/** The atom of the PropertyNotify being handled, or XCB_NONE */
+static xcb_atom_t property_notify_atom;
+
+static void property_request_limited(client_t *, client_limited_t);
+
+/** Send a property request, its reply is handled in property_refresh().
+ * \param c The client.
+ * \param atom The property atom, for the statistics, or XCB_NONE.
+ * \param get The function sending the request.
+ * \param update The function handling the reply.
+ */
+static void
+property_request_send(client_t *c, xcb_atom_t atom,
+                      property_get_func_t get, property_update_func_t update)
+{
+    foreach(req, property_requests)
+        if(req->client == c && req->update == update)
+        {
+            /* The property changed again, the pending reply may be stale */
+            xcb_discard_reply(globalconf.connection, req->cookie.sequence);
+            req->cookie = get(c->window);
+            return;
+        }
+
+    property_request_array_append(&property_requests,
+                                  (property_request_t) {
+                                      .client = c,
+                                      .window = c->window,
+                                      .atom = atom,
+                                      .update = update,
+                                      .cookie = get(c->window)
+                                  });
+}
+
+static void
+property_delayed_delete(gpointer data)
+{
+    property_delayed_t *delayed = data;
+    p_delete(&delayed);
+}
+
+static gboolean
+property_delayed_timeout(gpointer data)
+{
+    property_delayed_t *delayed = data;
+    client_t *c = delayed->client;
+
+    if(client_getbywin(delayed->window) == c)
+    {
+        c->limited[delayed->property].source_id = 0;
+        property_request_limited(c, delayed->property);
+    }
+
+    return FALSE;
+}
+
+/** Update a rate limited property, or delay the update if the previous one
+ * was too recent. Changes happening while an update is delayed are folded
+ * into it, since it reads the latest value anyway.
+ * \param c The client.
+ * \param property The property to update.
+ */
+static void
+property_request_limited(client_t *c, client_limited_t property)
+{
+    gint64 now = g_get_monotonic_time();
+    gint64 next = c->limited[property].last + c->update_interval * G_USEC_PER_SEC;
+
+    if(c->limited[property].source_id)
+        return;
+
+    if(now < next)
+    {
+        property_delayed_t *delayed = p_new(property_delayed_t, 1);
+        delayed->client = c;
+        delayed->window = c->window;
+        delayed->property = property;
+        c->limited[property].source_id =
+            g_timeout_add_full(G_PRIORITY_DEFAULT, (next - now + 999) / 1000,
+                               property_delayed_timeout, delayed,
+                               property_delayed_delete);
+        return;
+    }
+
+    c->limited[property].last = now;
+    property_request_send(c, property_limited_atom(property),
+                          property_limited[property].get,
+                          property_limited[property].update);
+}
+
+/** Ask the X server for a new value of a client property.
+ * The reply is handled in the next property_refresh(), so that a burst of
+ * property changes only costs a single round-trip. Name and icon updates
+ * are rate limited according to the client update interval.
+ * \param c The client.
+ * \param get The function sending the request.
+ * \param update The function handling the reply.
+ */
+static void
+property_request(client_t *c, property_get_func_t get, property_update_func_t update)
+{
+    for(int i = 0; i < CLIENT_LIMITED_COUNT; i++)
+        if(property_limited[i].update == update)
+        {
+            property_request_limited(c, i);
+            return;
+        }
+
+    property_request_send(c, property_notify_atom, get, update);
+}
+
+/** Handle the replies of all property requests sent since the last call.
+ */
+void
+property_refresh(void)
+{
+    property_request_array_t requests = property_requests;
+
+    if(!requests.len)
+        return;
+
+    /* The update functions emit signals, start with a fresh list */
+    property_request_array_init(&property_requests);
+
+    foreach(req, requests)
+        /* The client may have been unmanaged in the meantime */
+        if(client_getbywin(req->window) == req->client)
+        {
+            gint64 start = g_get_monotonic_time();
+            req->update(req->client, req->cookie);
+            /* The PropertyNotify only sent the request, the work is here */
+            if(req->atom != XCB_NONE)
+                event_stats_property_update(req->atom, g_get_monotonic_time() - start);
+        }
+        else
+            xcb_discard_reply(globalconf.connection, req->cookie.sequence);
+
+    property_request_array_wipe(&requests);
+}
 
 #define HANDLE_TEXT_PROPERTY(funcname, atom, setfunc) \
     xcb_get_property_cookie_t \
-    property_get_##funcname(client_t *c) \
+    property_get_##funcname(xcb_window_t window) \
     { \
         return xcb_get_property(globalconf.connection, \
                                 false, \
-                                c->window, \
+                                window, \
                                 atom, \
                                 XCB_GET_PROPERTY_TYPE_ANY, \
                                 0, \
@@ -59,7 +287,8 @@
     { \
         client_t *c = client_getbywin(window); \
         if(c) \
-            property_update_##funcname(c, property_get_##funcname(c));\
+            property_request(c, property_get_##funcname, \
+                             property_update_##funcname); \
         return 0; \
     }
 
@@ -80,7 +309,8 @@ HANDLE_TEXT_PROPERTY(wm_window_role, WM_WINDOW_ROLE, client_set_role)
     { \
         client_t *c = client_getbywin(window); \
         if(c) \
-            property_update_##name(c, property_get_##name(c));\
+            property_request(c, property_get_##name, \
+                             property_update_##name); \
         return 0; \
     }
 
@@ -96,9 +326,9 @@ HANDLE_PROPERTY(net_wm_pid)
 #undef HANDLE_PROPERTY
 
 xcb_get_property_cookie_t
-property_get_wm_transient_for(client_t *c)
+property_get_wm_transient_for(xcb_window_t window)
 {
-    return xcb_icccm_get_wm_transient_for_unchecked(globalconf.connection, c->window);
+    return xcb_icccm_get_wm_transient_for_unchecked(globalconf.connection, window);
 }
 
 void
@@ -119,9 +349,9 @@ property_update_wm_transient_for(client_t *c, xcb_get_property_cookie_t cookie)
 }
 
 xcb_get_property_cookie_t
-property_get_wm_client_leader(client_t *c)
+property_get_wm_client_leader(xcb_window_t window)
 {
-    return xcb_get_property_unchecked(globalconf.connection, false, c->window,
+    return xcb_get_property_unchecked(globalconf.connection, false, window,
                                       WM_CLIENT_LEADER, XCB_ATOM_WINDOW, 0, 32);
 }
 
@@ -138,15 +368,15 @@ property_update_wm_client_leader(client_t *c, xcb_get_property_cookie_t cookie)
     reply = xcb_get_property_reply(globalconf.connection, cookie, NULL);
 
     if(reply && reply->value_len && (data = xcb_get_property_value(reply)))
-        c->leader_window = *(xcb_window_t *) data;
+        client_set_leader_window(c, *(xcb_window_t *) data);
 
     p_delete(&reply);
 }
 
 xcb_get_property_cookie_t
-property_get_wm_normal_hints(client_t *c)
+property_get_wm_normal_hints(xcb_window_t window)
 {
-    return xcb_icccm_get_wm_normal_hints_unchecked(globalconf.connection, c->window);
+    return xcb_icccm_get_wm_normal_hints_unchecked(globalconf.connection, window);
 }
 
 /** Update the size hints of a client.
@@ -162,9 +392,9 @@ property_update_wm_normal_hints(client_t *c, xcb_get_property_cookie_t cookie)
 }
 
 xcb_get_property_cookie_t
-property_get_wm_hints(client_t *c)
+property_get_wm_hints(xcb_window_t window)
 {
-    return xcb_icccm_get_wm_hints_unchecked(globalconf.connection, c->window);
+    return xcb_icccm_get_wm_hints_unchecked(globalconf.connection, window);
 }
 
 /** Update the WM hints of a client.
@@ -194,9 +424,9 @@ property_update_wm_hints(client_t *c, xcb_get_property_cookie_t cookie)
 }
 
 xcb_get_property_cookie_t
-property_get_wm_class(client_t *c)
+property_get_wm_class(xcb_window_t window)
 {
-    return xcb_icccm_get_wm_class_unchecked(globalconf.connection, c->window);
+    return xcb_icccm_get_wm_class_unchecked(globalconf.connection, window);
 }
 
 /** Update WM_CLASS of a client.
@@ -233,27 +463,115 @@ property_handle_net_wm_strut_partial(uint8_t state,
 }
 
 xcb_get_property_cookie_t
-property_get_net_wm_icon(client_t *c)
+property_get_net_wm_icon(xcb_window_t window)
 {
-    return ewmh_window_icon_get_unchecked(c->window);
+    return ewmh_window_icon_get_unchecked(window);
+}
+
+/** Set an icon decoded by a worker thread, in the main loop.
+ * \param data The icon job.
+ * \return FALSE, so that the source is removed.
+ */
+static gboolean
+property_icon_decoded(gpointer data)
+{
+    property_icon_job_t *job = data;
+    client_t *c = client_getbywin(job->window);
+
+    /* The client may be gone, or have a newer icon already */
+    if(job->surface && c == job->client && c->icon_serial == job->serial)
+    {
+        /* The decoded surface is ours, no need to copy it */
+        client_take_icon(c, job->surface);
+        job->surface = NULL;
+    }
+
+    return FALSE;
+}
+
+/** Free an icon job.
+ * \param data The icon job.
+ */
+static void
+property_icon_job_delete(gpointer data)
+{
+    property_icon_job_t *job = data;
+
+    if(job->surface)
+        cairo_surface_destroy(job->surface);
+    p_delete(&job->reply);
+    p_delete(&job);
+}
+
+/** Decode an icon, in a worker thread, and hand it back to the main loop.
+ * \param data The icon job.
+ * \param user_data Unused.
+ */
+static void
+property_icon_decode(gpointer data, gpointer user_data)
+{
+    property_icon_job_t *job = data;
+
+    job->surface = ewmh_window_icon_from_reply(job->reply);
+    p_delete(&job->reply);
+
+    g_idle_add_full(G_PRIORITY_DEFAULT, property_icon_decoded,
+                    job, property_icon_job_delete);
 }
 
 void
 property_update_net_wm_icon(client_t *c, xcb_get_property_cookie_t cookie)
 {
-    cairo_surface_t *surface = ewmh_window_icon_get_reply(cookie);
+    xcb_get_property_reply_t *reply =
+        xcb_get_property_reply(globalconf.connection, cookie, NULL);
+    cairo_surface_t *surface;
+
+    /* Icons still being decoded are outdated now */
+    c->icon_serial++;
+
+    /* Converting big icons takes a while, do not stall the event handling */
+    if(reply && xcb_get_property_value_length(reply) > PROPERTY_ICON_ASYNC_SIZE)
+    {
+        property_icon_job_t *job = p_new(property_icon_job_t, 1);
+
+        job->client = c;
+        job->window = c->window;
+        job->serial = c->icon_serial;
+        job->reply = reply;
+
+        if(!property_icon_pool)
+            property_icon_pool = g_thread_pool_new(property_icon_decode, NULL,
+                                                   PROPERTY_ICON_THREADS,
+                                                   FALSE, NULL);
+        g_thread_pool_push(property_icon_pool, job, NULL);
+        return;
+    }
+
+    surface = ewmh_window_icon_from_reply(reply);
+    p_delete(&reply);
 
     if(!surface)
         return;
 
-    client_set_icon(c, surface);
-    cairo_surface_destroy(surface);
+    client_take_icon(c, surface);
+}
+
+/** Stop the icon decoding threads, dropping the icons not decoded yet.
+ */
+void
+property_cleanup(void)
+{
+    if(property_icon_pool)
+    {
+        g_thread_pool_free(property_icon_pool, TRUE, TRUE);
+        property_icon_pool = NULL;
+    }
 }
 
 xcb_get_property_cookie_t
-property_get_net_wm_pid(client_t *c)
+property_get_net_wm_pid(xcb_window_t window)
 {
-    return xcb_get_property_unchecked(globalconf.connection, false, c->window, _NET_WM_PID, XCB_ATOM_CARDINAL, 0L, 1L);
+    return xcb_get_property_unchecked(globalconf.connection, false, window, _NET_WM_PID, XCB_ATOM_CARDINAL, 0L, 1L);
 }
 
 void
@@ -278,10 +596,10 @@ property_update_net_wm_pid(client_t *c, xcb_get_property_cookie_t cookie)
 }
 
 xcb_get_property_cookie_t
-property_get_wm_protocols(client_t *c)
+property_get_wm_protocols(xcb_window_t window)
 {
     return xcb_icccm_get_wm_protocols_unchecked(globalconf.connection,
-						c->window, WM_PROTOCOLS);
+						window, WM_PROTOCOLS);
 }
 
 /** Update the list of supported protocols for a client.
@@ -313,7 +631,10 @@ static int
 property_handle_xembed_info(uint8_t state,
                             xcb_window_t window)
 {
-    xembed_window_t *emwin = xembed_getbywin(&globalconf.embedded, window);
+    xembed_window_t *emwin = NULL;
+
+    if(winindex_has(WININDEX_XEMBED, window))
+        emwin = xembed_getbywin(&globalconf.embedded, window);
 
     if(emwin)
     {
@@ -359,7 +680,7 @@ static int
 property_handle_xrootpmap_id(uint8_t state,
                              xcb_window_t window)
 {
-    signal_object_emit(globalconf.L, &global_signals, "wallpaper_changed", 0);
+    signal_object_emit_id(globalconf.L, &global_signals, SIGNAL_wallpaper_changed, 0);
     return 0;
 }
 
@@ -418,7 +739,9 @@ property_handle_propertynotify(xcb_property_notify_event_t *ev)
 #undef HANDLE
 #undef END
 
+    property_notify_atom = ev->atom;
     (*handler)(ev->state, ev->window);
+    property_notify_atom = XCB_NONE;
 }
 
 // vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -24,8 +24,11 @@
 
 #include "globalconf.h"
 
+typedef xcb_get_property_cookie_t (*property_get_func_t)(xcb_window_t);
+typedef void (*property_update_func_t)(client_t *, xcb_get_property_cookie_t);
+
 #define PROPERTY(funcname) \
-    xcb_get_property_cookie_t property_get_##funcname(client_t *c); \
+    xcb_get_property_cookie_t property_get_##funcname(xcb_window_t window); \
     void property_update_##funcname(client_t *c, xcb_get_property_cookie_t cookie)
 
 PROPERTY(wm_name);
@@ -46,6 +49,8 @@ PROPERTY(net_wm_icon);
 #undef PROPERTY
 
 void property_handle_propertynotify(xcb_property_notify_event_t *ev);
+void property_refresh(void);
+void property_cleanup(void);
 
 #endif
 // vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -348,7 +348,7 @@ screen_client_moveto(client_t *c, screen_t *new_screen, bool doresize)
     if(!doresize)
     {
         luaA_object_push(globalconf.L, c);
-        luaA_object_emit_signal(globalconf.L, -1, "property::screen", 0);
+        luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_screen, 0);
         lua_pop(globalconf.L, 1);
         if(had_focus)
             client_focus(c);
@@ -378,7 +378,7 @@ screen_client_moveto(client_t *c, screen_t *new_screen, bool doresize)
     /* move / resize the client */
     client_resize(c, new_geometry, false);
     luaA_object_push(globalconf.L, c);
-    luaA_object_emit_signal(globalconf.L, -1, "property::screen", 0);
+    luaA_object_emit_signal_id(globalconf.L, -1, SIGNAL_property_screen, 0);
     lua_pop(globalconf.L, 1);
     if(had_focus)
         client_focus(c);
@@ -542,7 +542,7 @@ luaA_screen_connect_signal(lua_State *L)
     screen_t *s = *ps;
     const char *name = luaL_checkstring(L, 2);
     luaA_checkfunction(L, 3);
-    signal_connect(&s->signals, name, luaA_object_ref(L, 3));
+    signal_connect(&s->signals, name, luaA_function_ref(L, 3));
     return 0;
 }
 
@@ -563,7 +563,7 @@ luaA_screen_disconnect_signal(lua_State *L)
     luaA_checkfunction(L, 3);
     const void *ref = lua_topointer(L, 3);
     signal_disconnect(&s->signals, name, ref);
-    luaA_object_unref(L, (void *) ref);
+    luaA_function_unref(L, (void *) ref);
     return 0;
 }
 
@@ -581,6 +581,20 @@ screen_emit_signal(lua_State *L, screen_t *screen, const char *name, int nargs)
     signal_object_emit(L, &screen->signals, name, nargs + 1);
 }
 
+/** Emit a built-in signal to a screen.
+ * \param L The Lua VM state.
+ * \param screen The screen.
+ * \param id The signal identifier.
+ * \param nargs The number of arguments to the signal function.
+ */
+void
+screen_emit_signal_id(lua_State *L, screen_t *screen, unsigned long id, int nargs)
+{
+    luaA_pushscreen(L, screen);
+    lua_insert(L, - nargs - 1);
+    signal_object_emit_id(L, &screen->signals, id, nargs + 1);
+}
+
 /** Emit a signal to a screen.
  * \param L The Lua VM state.
  * \return The number of elements pushed on stack.
@@ -40,6 +40,7 @@ struct a_screen
 ARRAY_FUNCS(screen_t, screen, DO_NOTHING)
 
 void screen_emit_signal(lua_State *, screen_t *, const char *, int);
+void screen_emit_signal_id(lua_State *, screen_t *, unsigned long, int);
 void screen_scan(void);
 screen_t *screen_getbycoord(int, int);
 area_t screen_area_get(screen_t *, bool);
@@ -76,7 +76,7 @@ luaA_selection_get(lua_State *L)
              */
             event_handle(event);
             p_delete(&event);
-            awesome_refresh();
+            awesome_refresh_nested();
             continue;
         }
 
@@ -80,7 +80,7 @@ spawn_monitor_timeout(gpointer sequence)
              foreach(func, sig->sigfuncs)
              {
                  lua_pushvalue(globalconf.L, -1);
-                 luaA_object_push(globalconf.L, (void *) *func);
+                 luaA_function_push(globalconf.L, (void *) *func);
                  luaA_dofunction(globalconf.L, 1, 0);
              }
              lua_pop(globalconf.L, 1);
@@ -185,7 +185,7 @@ spawn_monitor_event(SnMonitorEvent *event, void *data)
         foreach(func, sig->sigfuncs)
         {
             lua_pushvalue(globalconf.L, -1);
-            luaA_object_push(globalconf.L, (void *) *func);
+            luaA_function_push(globalconf.L, (void *) *func);
             luaA_dofunction(globalconf.L, 1, 0);
         }
         lua_pop(globalconf.L, 1);
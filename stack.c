@@ -46,6 +46,7 @@ stack_client_push(client_t *c)
 {
     stack_client_remove(c);
     client_array_push(&globalconf.stack, c);
+    client_transient_restack(c, false);
     ewmh_update_net_client_list_stacking();
     stack_windows();
 }
@@ -58,6 +59,7 @@ stack_client_append(client_t *c)
 {
     stack_client_remove(c);
     client_array_append(&globalconf.stack, c);
+    client_transient_restack(c, true);
     ewmh_update_net_client_list_stacking();
     stack_windows();
 }
@@ -70,42 +72,48 @@ stack_windows(void)
     need_stack_refresh = true;
 }
 
-/** Stack a window above another window, without causing errors.
+DO_ARRAY(xcb_window_t, window, DO_NOTHING)
+
+/** Our windows, bottom first, in the order last sent to the X server */
+static window_array_t stack_committed;
+
+stack_stats_t stack_stats;
+
+/** Stack a window relatively to another window.
  * \param w The window.
- * \param previous The window which should be below this window.
+ * \param sibling The window which should be next to this window.
+ * \param mode XCB_STACK_MODE_ABOVE or XCB_STACK_MODE_BELOW.
  */
 static void
-stack_window_above(xcb_window_t w, xcb_window_t previous)
+stack_window_configure(xcb_window_t w, xcb_window_t sibling, uint32_t mode)
 {
-    if (previous == XCB_NONE)
-        /* This would cause an error from the X server. Also, if we really
-         * changed the stacking order of all windows, they'd all have to redraw
-         * themselves. Doing it like this is better. */
-        return;
-
     xcb_configure_window(globalconf.connection, w,
                          XCB_CONFIG_WINDOW_SIBLING | XCB_CONFIG_WINDOW_STACK_MODE,
-                         (uint32_t[]) { previous, XCB_STACK_MODE_ABOVE });
+                         (uint32_t[]) { sibling, mode });
+    stack_stats.requests++;
 }
 
-/** Stack a client above.
- * \param client The client.
- * \param previous The previous client on the stack.
- * \return The next-previous!
+/** Add a client and its transient windows to a stacking order.
+ * \param c The client.
+ * \param order The stacking order, bottom first.
  */
-static xcb_window_t
-stack_client_above(client_t *c, xcb_window_t previous)
+static void
+stack_client_above(client_t *c, window_array_t *order)
 {
-    stack_window_above(c->frame_window, previous);
+    client_array_t *modals;
 
-    previous = c->frame_window;
+    window_array_append(order, c->frame_window);
 
     /* stack transient window on top of their parents */
-    foreach(node, globalconf.stack)
-        if((*node)->transient_for == c)
-            previous = stack_client_above(*node, previous);
+    foreach(node, c->transients)
+        stack_client_above(*node, order);
 
-    return previous;
+    /* Modal windows which are not transient for a window are modal for their
+     * whole group: stack them on top of every member of it. The last place
+     * they get is kept, see stack_order_uniq(). */
+    if(!c->modal && !c->transient_for && (modals = client_get_group_modals(c->leader_window)))
+        foreach(node, *modals)
+            stack_client_above(*node, order);
 }
 
 /** Stacking layout layers */
@@ -156,9 +164,87 @@ client_layer_translator(client_t *c)
     return WINDOW_LAYER_NORMAL;
 }
 
+/** Remove the windows appearing more than once from a stacking order. A
+ * window stacked twice ends up at its last place, like it did when each of
+ * them was sent to the X server.
+ * \param order The stacking order, bottom first.
+ */
+static void
+stack_order_uniq(window_array_t *order)
+{
+    GHashTable *seen = g_hash_table_new(g_direct_hash, g_direct_equal);
+    int j = order->len;
+
+    for(int i = order->len - 1; i >= 0; i--)
+        if(!g_hash_table_contains(seen, GUINT_TO_POINTER(order->tab[i])))
+        {
+            g_hash_table_add(seen, GUINT_TO_POINTER(order->tab[i]));
+            order->tab[--j] = order->tab[i];
+        }
+
+    memmove(order->tab, order->tab + j, sizeof(*order->tab) * (order->len - j));
+    order->len -= j;
+
+    g_hash_table_destroy(seen);
+}
+
+/** Find the windows of a stacking order which do not need to move. These are
+ * a longest sequence of windows which already are in the right order in the
+ * committed stacking order.
+ * \param order The stacking order, bottom first.
+ * \param keep Set to true for each window which does not need to move.
+ */
+static void
+stack_order_keep(window_array_t *order, bool *keep)
+{
+    GHashTable *committed = g_hash_table_new(g_direct_hash, g_direct_equal);
+    int *position = p_new(int, order->len);
+    /* tails[k] is the index of the smallest tail of a sequence of length k + 1 */
+    int *tails = p_new(int, order->len);
+    int *previous = p_new(int, order->len);
+    int len = 0;
+
+    for(int i = 0; i < stack_committed.len; i++)
+        g_hash_table_insert(committed, GUINT_TO_POINTER(stack_committed.tab[i]),
+                            GINT_TO_POINTER(i + 1));
+
+    for(int i = 0; i < order->len; i++)
+    {
+        keep[i] = false;
+        position[i] = GPOINTER_TO_INT(g_hash_table_lookup(committed,
+                                                          GUINT_TO_POINTER(order->tab[i]))) - 1;
+        /* New windows always have to be stacked */
+        if(position[i] < 0)
+            continue;
+
+        int lo = 0, hi = len;
+        while(lo < hi)
+        {
+            int mid = (lo + hi) / 2;
+            if(position[tails[mid]] < position[i])
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        previous[i] = lo > 0 ? tails[lo - 1] : -1;
+        tails[lo] = i;
+        if(lo == len)
+            len++;
+    }
+
+    for(int i = len > 0 ? tails[len - 1] : -1; i >= 0; i = previous[i])
+        keep[i] = true;
+
+    p_delete(&position);
+    p_delete(&tails);
+    p_delete(&previous);
+    g_hash_table_destroy(committed);
+}
+
 /** Restack clients.
- * \todo It might be worth stopping to restack everyone and only stack `c'
- * relatively to the first matching in the list.
+ * Only the windows which are not already in the right order relatively to the
+ * others are sent to the X server, so raising one window costs one request.
  */
 void
 stack_refresh()
@@ -166,38 +252,90 @@ stack_refresh()
     if(!need_stack_refresh)
         return;
 
-    xcb_window_t next = XCB_NONE;
+    static client_array_t layers[WINDOW_LAYER_COUNT];
+    window_array_t order;
+    bool *keep;
+
+    window_array_init(&order);
+
+    for(window_layer_t layer = WINDOW_LAYER_IGNORE; layer < WINDOW_LAYER_COUNT; layer++)
+        layers[layer].len = 0;
+    foreach(node, globalconf.stack)
+        client_array_append(&layers[client_layer_translator(*node)], *node);
 
     /* stack desktop windows */
-    for(window_layer_t layer = WINDOW_LAYER_DESKTOP; layer < WINDOW_LAYER_BELOW; layer++)
-        foreach(node, globalconf.stack)
-            if(client_layer_translator(*node) == layer)
-                next = stack_client_above(*node, next);
+    foreach(node, layers[WINDOW_LAYER_DESKTOP])
+        stack_client_above(*node, &order);
 
     /* first stack not ontop drawin window */
     foreach(drawin, globalconf.drawins)
         if(!(*drawin)->ontop)
-        {
-            stack_window_above((*drawin)->window, next);
-            next = (*drawin)->window;
-        }
+            window_array_append(&order, (*drawin)->window);
 
     /* then stack clients */
     for(window_layer_t layer = WINDOW_LAYER_BELOW; layer < WINDOW_LAYER_COUNT; layer++)
-        foreach(node, globalconf.stack)
-            if(client_layer_translator(*node) == layer)
-                next = stack_client_above(*node, next);
+        foreach(node, layers[layer])
+            stack_client_above(*node, &order);
 
     /* then stack ontop drawin window */
     foreach(drawin, globalconf.drawins)
         if((*drawin)->ontop)
+            window_array_append(&order, (*drawin)->window);
+
+    stack_order_uniq(&order);
+
+    keep = p_new(bool, order.len);
+    stack_order_keep(&order, keep);
+
+    /* The lowest window which does not move anchors the others. If all of
+     * them move, the top one stays where it is. */
+    int anchor = order.len - 1;
+    for(int i = 0; i < order.len; i++)
+        if(keep[i])
         {
-            stack_window_above((*drawin)->window, next);
-            next = (*drawin)->window;
+            anchor = i;
+            break;
         }
 
+    /* Put the windows below the anchor under each other, going down */
+    for(int i = anchor - 1; i >= 0; i--)
+        stack_window_configure(order.tab[i], order.tab[i + 1], XCB_STACK_MODE_BELOW);
+
+    /* Put every other moved window just above the one which should be below
+     * it, which is already at its final place. */
+    for(int i = anchor + 1; i < order.len; i++)
+        if(!keep[i])
+            stack_window_configure(order.tab[i], order.tab[i - 1], XCB_STACK_MODE_ABOVE);
+
+    p_delete(&keep);
+
+    window_array_wipe(&stack_committed);
+    stack_committed = order;
+
+    stack_stats.refreshes++;
+    stack_stats.windows += stack_committed.len;
+
     need_stack_refresh = false;
 }
 
+/** Get statistics about restacking.
+ * \param L The Lua VM state.
+ * \return The number of elements pushed on stack.
+ * \luastack
+ * \lreturn A table with the number of refreshes which restacked windows, the
+ * number of windows they stacked and the number of requests sent to do so.
+ */
+int
+luaA_stack_stats(lua_State *L)
+{
+    lua_newtable(L);
+    lua_pushnumber(L, stack_stats.refreshes);
+    lua_setfield(L, -2, "refreshes");
+    lua_pushnumber(L, stack_stats.windows);
+    lua_setfield(L, -2, "windows");
+    lua_pushnumber(L, stack_stats.requests);
+    lua_setfield(L, -2, "requests");
+    return 1;
+}
 
 // vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
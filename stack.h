@@ -24,11 +24,25 @@
 
 #include "globalconf.h"
 
+/** Statistics about restacking */
+typedef struct
+{
+    /** Number of refreshes which restacked windows */
+    unsigned long refreshes;
+    /** Number of windows in the stacking order of these refreshes */
+    unsigned long windows;
+    /** Number of requests sent to restack a window */
+    unsigned long requests;
+} stack_stats_t;
+
+extern stack_stats_t stack_stats;
+
 void stack_client_remove(client_t *);
 void stack_client_push(client_t *);
 void stack_client_append(client_t *);
 void stack_windows(void);
 void stack_refresh(void);
+int luaA_stack_stats(lua_State *);
 
 #endif
 // vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -27,6 +27,7 @@
 #include "screen.h"
 #include "systray.h"
 #include "xwindow.h"
+#include "winindex.h"
 #include "common/array.h"
 #include "common/atoms.h"
 #include "common/xutil.h"
@@ -154,7 +155,7 @@ systray_request_handle(xcb_window_t embed_win, xembed_info_t *info)
     };
 
     /* check if not already trayed */
-    if(xembed_getbywin(&globalconf.embedded, embed_win))
+    if(winindex_has(WININDEX_XEMBED, embed_win))
         return -1;
 
     p_clear(&em_cookie, 1);
@@ -186,6 +187,7 @@ systray_request_handle(xcb_window_t embed_win, xembed_info_t *info)
                            MIN(XEMBED_VERSION, em.info.version));
 
     xembed_window_array_append(&globalconf.embedded, em);
+    winindex_add(WININDEX_XEMBED, em.win, NULL);
     luaA_systray_invalidate();
 
     return 0;
@@ -220,23 +222,30 @@ systray_process_client_message(xcb_client_message_event_t *ev)
     return ret;
 }
 
-/** Check if a window is a KDE tray.
+/** Send the request checking if a window is a KDE tray.
  * \param w The window to check.
+ * \return The cookie associated with the request.
+ */
+xcb_get_property_cookie_t
+systray_iskdedockapp_unchecked(xcb_window_t w)
+{
+    /* Check if that is a KDE tray because it does not respect fdo standards,
+     * thanks KDE. */
+    return xcb_get_property_unchecked(globalconf.connection, false, w,
+                                      _KDE_NET_WM_SYSTEM_TRAY_WINDOW_FOR,
+                                      XCB_ATOM_WINDOW, 0, 1);
+}
+
+/** Get the reply of a KDE tray check.
+ * \param kde_check_q The cookie returned by systray_iskdedockapp_unchecked().
  * \return True if it is, false otherwise.
  */
 bool
-systray_iskdedockapp(xcb_window_t w)
+systray_iskdedockapp_reply(xcb_get_property_cookie_t kde_check_q)
 {
-    xcb_get_property_cookie_t kde_check_q;
     xcb_get_property_reply_t *kde_check;
     bool ret;
 
-    /* Check if that is a KDE tray because it does not respect fdo standards,
-     * thanks KDE. */
-    kde_check_q = xcb_get_property_unchecked(globalconf.connection, false, w,
-                                             _KDE_NET_WM_SYSTEM_TRAY_WINDOW_FOR,
-                                             XCB_ATOM_WINDOW, 0, 1);
-
     kde_check = xcb_get_property_reply(globalconf.connection, kde_check_q, NULL);
 
     /* it's a KDE systray ?*/
@@ -247,6 +256,16 @@ systray_iskdedockapp(xcb_window_t w)
     return ret;
 }
 
+/** Check if a window is a KDE tray.
+ * \param w The window to check.
+ * \return True if it is, false otherwise.
+ */
+bool
+systray_iskdedockapp(xcb_window_t w)
+{
+    return systray_iskdedockapp_reply(systray_iskdedockapp_unchecked(w));
+}
+
 /** Handle xembed client message.
  * \param ev The event.
  * \return 0 on no error.
@@ -268,7 +287,7 @@ xembed_process_client_message(xcb_client_message_event_t *ev)
 void
 luaA_systray_invalidate(void)
 {
-    signal_object_emit(globalconf.L, &global_signals, "systray::update", 0);
+    signal_object_emit_id(globalconf.L, &global_signals, SIGNAL_systray_update, 0);
 }
 
 static void
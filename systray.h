@@ -30,6 +30,8 @@ void systray_init(void);
 void systray_cleanup(void);
 int systray_request_handle(xcb_window_t, xembed_info_t *);
 bool systray_iskdedockapp(xcb_window_t);
+xcb_get_property_cookie_t systray_iskdedockapp_unchecked(xcb_window_t);
+bool systray_iskdedockapp_reply(xcb_get_property_cookie_t);
 int systray_process_client_message(xcb_client_message_event_t *);
 int xembed_process_client_message(xcb_client_message_event_t *);
 int luaA_systray(lua_State *);
@@ -0,0 +1,134 @@
+/*
+ * awesome-bench-clients.c - synthetic X clients for the benchmarks
+ *
+ * Copyright © 2014 awesome developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <xcb/xcb.h>
+
+/** Intern an atom.
+ * \param c The X connection.
+ * \param name The atom name.
+ * \return The atom.
+ */
+static xcb_atom_t
+intern_atom(xcb_connection_t *c, const char *name)
+{
+    xcb_intern_atom_reply_t *reply =
+        xcb_intern_atom_reply(c, xcb_intern_atom(c, false, strlen(name), name), NULL);
+    xcb_atom_t atom = XCB_NONE;
+
+    if(reply)
+    {
+        atom = reply->atom;
+        free(reply);
+    }
+
+    return atom;
+}
+
+/** Set the _NET_WM_NAME of a window.
+ * \param c The X connection.
+ * \param win The window.
+ * \param net_wm_name The _NET_WM_NAME atom.
+ * \param utf8_string The UTF8_STRING atom.
+ * \param name The new name.
+ */
+static void
+set_name(xcb_connection_t *c, xcb_window_t win,
+         xcb_atom_t net_wm_name, xcb_atom_t utf8_string, const char *name)
+{
+    xcb_change_property(c, XCB_PROP_MODE_REPLACE, win, net_wm_name,
+                        utf8_string, 8, strlen(name), name);
+}
+
+/** Create COUNT windows, then rewrite the name of each of them CHURN times.
+ * The last name of window i is "bench i done". The windows stay around
+ * until the X connection is closed or the process is killed.
+ */
+int
+main(int argc, char **argv)
+{
+    xcb_connection_t *c;
+    xcb_screen_t *screen;
+    xcb_window_t *wins;
+    xcb_atom_t net_wm_name, utf8_string;
+    xcb_generic_event_t *event;
+    int count, churn;
+    char name[64];
+
+    if(argc < 2)
+    {
+        fprintf(stderr, "Usage: %s COUNT [CHURN]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    count = atoi(argv[1]);
+    churn = argc > 2 ? atoi(argv[2]) : 0;
+
+    c = xcb_connect(NULL, NULL);
+    if(xcb_connection_has_error(c))
+    {
+        fprintf(stderr, "%s: cannot open display\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    screen = xcb_setup_roots_iterator(xcb_get_setup(c)).data;
+    net_wm_name = intern_atom(c, "_NET_WM_NAME");
+    utf8_string = intern_atom(c, "UTF8_STRING");
+    wins = calloc(count, sizeof(*wins));
+
+    for(int i = 0; i < count; i++)
+    {
+        wins[i] = xcb_generate_id(c);
+        xcb_create_window(c, XCB_COPY_FROM_PARENT, wins[i], screen->root,
+                          0, 0, 100, 100, 0, XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                          screen->root_visual, XCB_CW_BACK_PIXEL,
+                          (const uint32_t []) { screen->white_pixel });
+        snprintf(name, sizeof(name), "bench %d", i);
+        set_name(c, wins[i], net_wm_name, utf8_string, name);
+        xcb_map_window(c, wins[i]);
+    }
+    xcb_flush(c);
+
+    for(int n = 1; n <= churn; n++)
+        for(int i = 0; i < count; i++)
+        {
+            if(n == churn)
+                snprintf(name, sizeof(name), "bench %d done", i);
+            else
+                snprintf(name, sizeof(name), "bench %d churn %d", i, n);
+            set_name(c, wins[i], net_wm_name, utf8_string, name);
+        }
+    xcb_flush(c);
+
+    while((event = xcb_wait_for_event(c)))
+        free(event);
+
+    free(wins);
+    xcb_disconnect(c);
+
+    return EXIT_SUCCESS;
+}
+
+// vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -0,0 +1,76 @@
+---------------------------------------------------------------------------
+-- gears.object signal emission microbenchmark.
+--
+-- usage: lua awesome-bench-gears.lua LIBDIR [OBJECTS [EMITS [OUTPUT]]]
+--
+-- LIBDIR is the directory holding the built Lua libraries. EMITS signals
+-- (default: 1000000) are emitted round-robin across OBJECTS objects (default:
+-- 1000), each with three connected callbacks like a widget. Results are
+-- written to OUTPUT (default: standard output) as "name value" lines, times
+-- are in seconds.
+---------------------------------------------------------------------------
+
+local libdir = arg[1]
+if not libdir then
+    io.stderr:write("usage: " .. arg[0] .. " LIBDIR [OBJECTS [EMITS [OUTPUT]]]\n")
+    os.exit(1)
+end
+package.path = libdir .. "/?.lua;" .. libdir .. "/?/init.lua;" .. package.path
+
+local object = require("gears.object")
+
+local nobjects = tonumber(arg[2]) or 1000
+local nemits = tonumber(arg[3]) or 1000000
+local output = arg[4]
+local results = {}
+
+local function record(name, value)
+    table.insert(results, string.format("%s %.9g", name, value))
+end
+
+local calls = 0
+local function handler() calls = calls + 1 end
+
+local objects = {}
+for i = 1, nobjects do
+    local obj = object()
+    obj:add_signal("widget::updated")
+    obj:connect_signal("widget::updated", handler)
+    obj:connect_signal("widget::updated", function() calls = calls + 1 end)
+    obj:connect_signal("widget::updated", function() calls = calls + 1 end)
+    objects[i] = obj
+end
+
+-- Plain emission
+local t0 = os.clock()
+for i = 1, nemits do
+    objects[i % nobjects + 1]:emit_signal("widget::updated")
+end
+local elapsed = os.clock() - t0
+record("gears_emit_total", elapsed)
+record("gears_emit_per_signal", elapsed / nemits)
+
+-- Emission with a callback disconnecting and reconnecting itself
+local function churn(obj)
+    obj:disconnect_signal("widget::updated", churn)
+    obj:connect_signal("widget::updated", churn)
+end
+for _, obj in ipairs(objects) do
+    obj:connect_signal("widget::updated", churn)
+end
+
+t0 = os.clock()
+for i = 1, nemits do
+    objects[i % nobjects + 1]:emit_signal("widget::updated")
+end
+elapsed = os.clock() - t0
+record("gears_emit_churn_total", elapsed)
+record("gears_emit_churn_per_signal", elapsed / nemits)
+
+local out = output and io.open(output, "w") or io.stdout
+out:write(table.concat(results, "\n") .. "\n")
+if output then
+    out:close()
+end
+
+-- vim: filetype=lua:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
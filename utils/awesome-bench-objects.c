@@ -0,0 +1,153 @@
+/*
+ * awesome-bench-objects.c - object reference schemes microbenchmark
+ *
+ * Copyright © 2014 awesome developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <lauxlib.h>
+
+#include "common/luaobject.h"
+
+/** An object of the benchmark class */
+typedef struct
+{
+    LUA_OBJECT_HEADER
+} bench_object_t;
+
+static lua_class_t bench_class;
+LUA_OBJECT_FUNCS(bench_class, bench_object_t, bench_object)
+
+/** Get the current time.
+ * \return The time in seconds.
+ */
+static double
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/** Print a benchmark result.
+ * \param out The stream to print to.
+ * \param name The benchmark name.
+ * \param start The time the benchmark started.
+ * \param ops The number of operations done.
+ */
+static void
+report(FILE *out, const char *name, double start, long ops)
+{
+    fprintf(out, "%s %.2f\n", name, (now() - start) * 1e9 / ops);
+}
+
+/** Compare the cost of referencing COUNT objects in the registry table, the
+ * way items and functions are, and in registry slots, the way objects are,
+ * pushing each of them ROUNDS times. Both go through the real reference
+ * functions of common/luaobject.c. Results are printed in nanoseconds per
+ * operation as "name value" lines.
+ */
+int
+main(int argc, char **argv)
+{
+    static const struct luaL_Reg bench_methods[] =
+    {
+        { NULL, NULL }
+    };
+    static const struct luaL_Reg bench_meta[] =
+    {
+        { NULL, NULL }
+    };
+    int count = argc > 1 ? atoi(argv[1]) : 1000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 1000;
+    FILE *out = argc > 3 ? fopen(argv[3], "w") : stdout;
+    lua_State *L = luaL_newstate();
+    void **pointers = calloc(count, sizeof(void *));
+    double start;
+
+    if(count <= 0 || rounds <= 0 || !out || !pointers)
+    {
+        fprintf(stderr, "usage: %s [COUNT [ROUNDS [OUTPUT]]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    luaA_object_setup(L);
+    luaA_class_setup(L, &bench_class, "bench", NULL,
+                     (lua_class_allocator_t) bench_object_new, NULL, NULL,
+                     NULL, NULL, bench_methods, bench_meta);
+
+    /* The registry table scheme */
+    start = now();
+    for(int i = 0; i < count; i++)
+    {
+        bench_object_new(L);
+        pointers[i] = luaA_function_ref(L, -1);
+    }
+    report(out, "table_ref", start, count);
+
+    start = now();
+    for(int r = 0; r < rounds; r++)
+        for(int i = 0; i < count; i++)
+        {
+            luaA_function_push(L, pointers[i]);
+            lua_pop(L, 1);
+        }
+    report(out, "table_push", start, (long) count * rounds);
+
+    start = now();
+    for(int i = 0; i < count; i++)
+        luaA_function_unref(L, pointers[i]);
+    report(out, "table_unref", start, count);
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    /* The registry slot scheme */
+    start = now();
+    for(int i = 0; i < count; i++)
+    {
+        bench_object_new(L);
+        pointers[i] = luaA_object_ref(L, -1);
+    }
+    report(out, "slot_ref", start, count);
+
+    start = now();
+    for(int r = 0; r < rounds; r++)
+        for(int i = 0; i < count; i++)
+        {
+            luaA_object_push(L, pointers[i]);
+            lua_pop(L, 1);
+        }
+    report(out, "slot_push", start, (long) count * rounds);
+
+    start = now();
+    for(int i = 0; i < count; i++)
+        luaA_object_unref(L, pointers[i]);
+    report(out, "slot_unref", start, count);
+
+    free(pointers);
+    lua_close(L);
+    if(out != stdout)
+        fclose(out);
+
+    return EXIT_SUCCESS;
+}
+
+// vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -0,0 +1,178 @@
+---------------------------------------------------------------------------
+-- Configuration file driving the awesome benchmarks, see awesome-bench.
+-- Results are written as "name value" lines, times are in seconds.
+---------------------------------------------------------------------------
+
+local GLib = require("lgi").GLib
+local awful = require("awful")
+
+local nclients = tonumber(os.getenv("AWESOME_BENCH_CLIENTS")) or 100
+local rounds = tonumber(os.getenv("AWESOME_BENCH_ROUNDS")) or 50
+local churn = tonumber(os.getenv("AWESOME_BENCH_CHURN")) or 1000
+local clients_bin = os.getenv("AWESOME_BENCH_CLIENTS_BIN") or "awesome-bench-clients"
+local output = os.getenv("AWESOME_BENCH_OUTPUT")
+local status = os.getenv("AWESOME_BENCH_STATUS")
+
+local tags = awful.tag({ 1, 2 }, 1, awful.layout.suit.tile)
+local results = {}
+local bench
+
+local function now()
+    return GLib.get_monotonic_time() / 1e6
+end
+
+local function record(name, value)
+    table.insert(results, string.format("%s %.6f", name, value))
+end
+
+local function resume()
+    local ok, err = coroutine.resume(bench)
+    if not ok then
+        io.stderr:write("awesome-bench: " .. tostring(err) .. "\n")
+        awesome.quit()
+    end
+end
+
+--- Let the main loop run, so that pending changes are applied by the
+-- refresh done before the next poll.
+local function sleep(timeout)
+    local t = timer { timeout = timeout or 0 }
+    t:connect_signal("timeout", function()
+        t:stop()
+        resume()
+    end)
+    t:start()
+    coroutine.yield()
+end
+
+local function wait_for(cond)
+    while not cond() do
+        sleep(0.01)
+    end
+end
+
+--- Run an action several times and record the average and maximum time until
+-- the main loop has applied it.
+local function series(name, action)
+    local total, max = 0, 0
+    for i = 1, rounds do
+        local t0 = now()
+        action(i)
+        sleep()
+        local dt = now() - t0
+        total = total + dt
+        max = math.max(max, dt)
+    end
+    record(name .. ".avg", total / rounds)
+    record(name .. ".max", max)
+end
+
+bench = coroutine.create(function()
+    -- Manage throughput
+    local t0 = now()
+    awful.util.spawn(clients_bin .. " " .. nclients, false)
+    wait_for(function() return #client.get() >= nclients end)
+    local dt = now() - t0
+    record("manage.total", dt)
+    record("manage.per_client", dt / nclients)
+    sleep()
+
+    -- Tag switch latency, all clients are on the first tag
+    series("tag_switch", function(i) awful.tag.viewonly(tags[i % 2 + 1]) end)
+    awful.tag.viewonly(tags[1])
+    sleep()
+
+    -- Restack time
+    local clients = client.get()
+    series("restack", function(i) clients[i % #clients + 1]:raise() end)
+
+    -- Mass resize under the tile layout
+    series("tile_resize", function(i)
+        awful.tag.incmwfact(i % 2 == 0 and 0.05 or -0.05, tags[1])
+    end)
+
+    -- Layouts computed in C and in Lua have to give the same geometries
+    local kernel = require("awful.layout.kernel")
+    local suit = awful.layout.suit
+    local mismatches = 0
+    for _, l in ipairs({ suit.tile, suit.tile.left, suit.tile.bottom, suit.tile.top,
+                         suit.fair, suit.fair.horizontal, suit.spiral, suit.spiral.dwindle,
+                         suit.max, suit.max.fullscreen, suit.magnifier }) do
+        awful.layout.set(l, tags[1])
+        local geometries = {}
+        for _, enabled in ipairs({ false, true }) do
+            kernel.enabled = enabled
+            local total = 0
+            for i = 1, rounds do
+                for _, c in ipairs(clients) do
+                    c:geometry({ x = i, y = i, width = 100, height = 100 })
+                end
+                local t0 = now()
+                awful.layout.arrange_now(1)
+                total = total + now() - t0
+            end
+            record("layout." .. l.name .. (enabled and ".c" or ".lua"), total / rounds)
+            geometries[enabled] = {}
+            for k, c in ipairs(clients) do
+                geometries[enabled][k] = c:geometry()
+            end
+        end
+        for k in ipairs(clients) do
+            local a, b = geometries[false][k], geometries[true][k]
+            if a.x ~= b.x or a.y ~= b.y or a.width ~= b.width or a.height ~= b.height then
+                mismatches = mismatches + 1
+            end
+        end
+    end
+    kernel.enabled = true
+    awful.layout.set(suit.tile, tags[1])
+    record("layout.mismatches", mismatches)
+
+    -- Property churn: one client renaming itself many times
+    local names, done = 0, false
+    local function on_name(c)
+        if c.name and c.name:find("^bench 0") then
+            names = names + 1
+            done = done or c.name == "bench 0 done"
+        end
+    end
+    for _, c in ipairs(client.get()) do c:kill() end
+    wait_for(function() return #client.get() == 0 end)
+    client.connect_signal("property::name", on_name)
+    t0 = now()
+    awful.util.spawn(clients_bin .. " 1 " .. churn, false)
+    wait_for(function() return done end)
+    record("property_churn.total", now() - t0)
+    record("property_churn.name_signals", names)
+    client.disconnect_signal("property::name", on_name)
+
+    local coalesced = awesome.event_stats().coalesced
+    for name, count in pairs(coalesced) do
+        record("coalesced." .. name, count)
+    end
+
+    local out = output and io.open(output, "w") or io.stdout
+    out:write(table.concat(results, "\n") .. "\n")
+    if out ~= io.stdout then
+        out:close()
+    end
+
+    if status then
+        local f = io.open(status, "w")
+        f:write("ok\n")
+        f:close()
+    end
+
+    for _, c in ipairs(client.get()) do c:kill() end
+    awesome.quit()
+end)
+
+-- Start once the configuration is loaded
+local start = timer { timeout = 0 }
+start:connect_signal("timeout", function()
+    start:stop()
+    resume()
+end)
+start:start()
+
+-- vim: filetype=lua:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
@@ -0,0 +1,86 @@
+/*
+ * winindex.c - window id to object index
+ *
+ * Copyright © 2014 awesome developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <glib.h>
+
+#include "winindex.h"
+
+/** One hash table per role, mapping a window id to its object. */
+static GHashTable *winindex[WININDEX_COUNT];
+
+/** Get the table for a role, creating it if needed.
+ * \param role The window role.
+ * \return The hash table.
+ */
+static GHashTable *
+winindex_table(winindex_role_t role)
+{
+    if(!winindex[role])
+        winindex[role] = g_hash_table_new(g_direct_hash, g_direct_equal);
+    return winindex[role];
+}
+
+/** Register a window in the index.
+ * \param role The role this window has.
+ * \param win The window id.
+ * \param object The object owning this window, may be NULL.
+ */
+void
+winindex_add(winindex_role_t role, xcb_window_t win, void *object)
+{
+    if(win != XCB_NONE)
+        g_hash_table_insert(winindex_table(role), GUINT_TO_POINTER(win), object);
+}
+
+/** Remove a window from the index.
+ * \param role The role this window has.
+ * \param win The window id.
+ */
+void
+winindex_remove(winindex_role_t role, xcb_window_t win)
+{
+    g_hash_table_remove(winindex_table(role), GUINT_TO_POINTER(win));
+}
+
+/** Get the object owning a window.
+ * \param role The role the window should have.
+ * \param win The window id.
+ * \return The object if found, NULL otherwise.
+ */
+void *
+winindex_get(winindex_role_t role, xcb_window_t win)
+{
+    return g_hash_table_lookup(winindex_table(role), GUINT_TO_POINTER(win));
+}
+
+/** Check if a window is registered with a role.
+ * \param role The role the window should have.
+ * \param win The window id.
+ * \return True if the window is known with this role.
+ */
+bool
+winindex_has(winindex_role_t role, xcb_window_t win)
+{
+    return g_hash_table_lookup_extended(winindex_table(role), GUINT_TO_POINTER(win),
+                                        NULL, NULL);
+}
+
+// vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80
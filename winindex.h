@@ -0,0 +1,48 @@
+/*
+ * winindex.h - window id to object index header
+ *
+ * Copyright © 2014 awesome developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef AWESOME_WININDEX_H
+#define AWESOME_WININDEX_H
+
+#include <stdbool.h>
+#include <xcb/xcb.h>
+
+/** The role a window plays for us. */
+typedef enum
+{
+    /** A managed client window. */
+    WININDEX_CLIENT,
+    /** The frame window of a managed client. */
+    WININDEX_FRAME,
+    /** A visible drawin. */
+    WININDEX_DRAWIN,
+    /** A window embedded in the systray. */
+    WININDEX_XEMBED,
+    WININDEX_COUNT
+} winindex_role_t;
+
+void winindex_add(winindex_role_t, xcb_window_t, void *);
+void winindex_remove(winindex_role_t, xcb_window_t);
+void * winindex_get(winindex_role_t, xcb_window_t);
+bool winindex_has(winindex_role_t, xcb_window_t);
+
+#endif
+// vim: filetype=c:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:textwidth=80